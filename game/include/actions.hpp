@@ -11,6 +11,10 @@
 namespace open_spiel {
 namespace dominion {
 
+// Player (non-chance) action ids are [0, kNumPlayerActions); chance outcomes
+// start at ActionIds::Shuffle() == kNumPlayerActions.
+inline constexpr int kNumPlayerActions = 5 * kNumSupplyPiles + 5;
+
 // Centralized action ID registry. Avoids magic numbers by providing
 // clearly named constructors and queries for action IDs used by Dominion.
 namespace ActionIds {
@@ -50,6 +54,12 @@ namespace ActionIds {
 
   // Chance outcome used in sampled stochastic mode for deck shuffling.
   inline Action Shuffle() { return GainSelectBase() + kNumSupplyPiles; }
+  // Sampled mode: shuffle seed outcome i in [0, kNumShuffleSeeds). The seed
+  // fixes the resulting deck order; Shuffle() is seed 0.
+  inline Action ShuffleSeed(int i) { return Shuffle() + i; }
+  // Explicit-chance mode: index into the enumerated draw outcomes of the
+  // current chance node, i in [0, kMaxDrawOutcomes).
+  inline Action DrawOutcome(int i) { return Shuffle() + i; }
 
   // Composite heuristic action: play a non-terminal action chosen by engine.
   // inline Action PlayNonTerminal() { return static_cast<Action>(Shuffle() + 1); }
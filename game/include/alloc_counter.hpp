@@ -0,0 +1,34 @@
+#ifndef OPEN_SPIEL_GAMES_DOMINION_ALLOC_COUNTER_H_
+#define OPEN_SPIEL_GAMES_DOMINION_ALLOC_COUNTER_H_
+
+#include <cstdint>
+
+namespace open_spiel {
+namespace dominion {
+namespace alloc {
+
+// Heap allocation accounting for tests and benchmarks. Linking the
+// dominion_alloc_counter library replaces the global operator new/delete
+// with counting versions; the game library itself never links it.
+
+// Allocations made by the whole process so far.
+uint64_t ProcessAllocations();
+// Allocations made by the calling thread so far.
+uint64_t ThreadAllocations();
+
+// Counts the calling thread's allocations since construction (or Restart).
+class AllocationScope {
+public:
+  AllocationScope() : start_(ThreadAllocations()) {}
+  void Restart() { start_ = ThreadAllocations(); }
+  uint64_t Allocations() const { return ThreadAllocations() - start_; }
+
+private:
+  uint64_t start_;
+};
+
+} // namespace alloc
+} // namespace dominion
+} // namespace open_spiel
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef OPEN_SPIEL_GAMES_DOMINION_BATCH_ENV_H_
+#define OPEN_SPIEL_GAMES_DOMINION_BATCH_ENV_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "actions.hpp"
+#include "dominion.hpp"
+#include "open_spiel/spiel.h"
+
+namespace open_spiel {
+namespace dominion {
+
+// N games stepped in lockstep for batched (NN-driven) actors.
+//
+// Step() applies one action per game and refreshes every output buffer in
+// one call. Outputs are structure-of-arrays: each is one contiguous buffer
+// with a fixed stride per game, so a caller can hand them to an inference
+// batch without gathering.
+//
+// Chance nodes are resolved inside the environment from a per-game random
+// stream (derived from the seed and the game slot), so every game is always
+// at a decision node. A game that ends is reported with its terminal flag
+// and final returns, then restarted at once: the observation, legal mask and
+// current player of that slot already describe the next game (auto-reset).
+// With the "opening_chance" game parameter the deal is sampled from the same
+// stream and the whole batch is reproducible from the seed.
+class BatchEnv {
+public:
+  static constexpr int kLegalMaskStride = kNumPlayerActions;
+
+  // `max_moves` bounds the decisions in one game; longer games are reported
+  // as truncated (with zero rewards) and restarted.
+  BatchEnv(std::shared_ptr<const Game> game, int batch_size, uint64_t seed,
+           int max_moves = 5000);
+
+  int BatchSize() const { return batch_size_; }
+
+  // Restarts every game and refreshes the outputs; rewards and flags are 0.
+  void Reset();
+  // Applies actions[i] to game i; each must be legal (see LegalMask()).
+  void Step(const Action *actions);
+  void Step(const std::vector<Action> &actions);
+
+  // [batch] player to move in each game.
+  const int32_t *CurrentPlayers() const { return current_player_.data(); }
+  // [batch][kNumPlayers] returns credited by the last step (nonzero only on
+  // the step that ended a game).
+  const float *Rewards() const { return rewards_.data(); }
+  // [batch] 1 if the last step ended the game in that slot.
+  const uint8_t *Terminals() const { return terminal_.data(); }
+  // [batch] 1 if the last step hit max_moves in that slot.
+  const uint8_t *Truncations() const { return truncated_.data(); }
+  // [batch][kObservationBytes] ObservationBytes() of the player to move.
+  const uint8_t *Observations() const { return observations_.data(); }
+  // [batch][kLegalMaskStride] 1 for each legal action id.
+  const uint8_t *LegalMask() const { return legal_mask_.data(); }
+
+  // Current state of one slot (always a decision node).
+  const DominionState &GameState(int i) const {
+    return static_cast<const DominionState &>(*states_[i]);
+  }
+  int64_t EpisodesCompleted() const { return episodes_; }
+
+private:
+  void ResetSlot(int i);
+  // Samples chance outcomes until slot i is at a decision or terminal node.
+  void ResolveChance(int i);
+  void WriteOutputs(int i);
+
+  std::shared_ptr<const Game> game_;
+  int batch_size_;
+  int max_moves_;
+  std::vector<std::unique_ptr<State>> states_;
+  std::vector<uint64_t> rng_;
+  std::vector<int> moves_;
+  int64_t episodes_ = 0;
+
+  std::vector<int32_t> current_player_;
+  std::vector<float> rewards_;
+  std::vector<uint8_t> terminal_;
+  std::vector<uint8_t> truncated_;
+  std::vector<uint8_t> observations_;
+  std::vector<uint8_t> legal_mask_;
+};
+
+} // namespace dominion
+} // namespace open_spiel
+
+#endif
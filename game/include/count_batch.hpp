@@ -0,0 +1,89 @@
+#ifndef OPEN_SPIEL_GAMES_DOMINION_COUNT_BATCH_H_
+#define OPEN_SPIEL_GAMES_DOMINION_COUNT_BATCH_H_
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+
+#include "count_kernels.hpp"
+#include "dominion.hpp"
+
+namespace open_spiel {
+namespace dominion {
+
+using count_kernels::kCountRowBytes;
+
+// Coin value of each basic treasure by pile, zero elsewhere; the weights
+// RowDots needs for the buy-phase coin total.
+const uint8_t *BasicTreasureValueRow();
+
+// Hand, discard, play-area and supply counts of many games, each kind in its
+// own contiguous, 64-byte-aligned block of count rows (structure of arrays):
+//   hand and discard: row game * kNumPlayers + player,
+//   play area and supply: row game.
+// Load() and Store() copy to and from DominionState; the bulk operations
+// run one kernel over a whole block.
+class CountBatch {
+public:
+  explicit CountBatch(int num_games);
+
+  int NumGames() const { return num_games_; }
+
+  uint8_t *Hand(int game, int player) { return Row(hand_.get(), game * kNumPlayers + player); }
+  uint8_t *Discard(int game, int player) {
+    return Row(discard_.get(), game * kNumPlayers + player);
+  }
+  uint8_t *PlayArea(int game) { return Row(play_.get(), game); }
+  uint8_t *Supply(int game) { return Row(supply_.get(), game); }
+  const uint8_t *Hand(int game, int player) const {
+    return Row(hand_.get(), game * kNumPlayers + player);
+  }
+  const uint8_t *Discard(int game, int player) const {
+    return Row(discard_.get(), game * kNumPlayers + player);
+  }
+  const uint8_t *PlayArea(int game) const { return Row(play_.get(), game); }
+  const uint8_t *Supply(int game) const { return Row(supply_.get(), game); }
+
+  // Copies the counts of `state` into slot `game`.
+  void Load(int game, const DominionState &state);
+  // Writes hand, discard and supply counts back. The play area keeps no
+  // order, so it is only written back once emptied (by CleanupMerge).
+  // Each player's PublicCardTracker follows the moves into the discard:
+  // known hand cards that left the hand, and the in-play cards once the
+  // play area is emptied, become known discards.
+  void Store(int game, DominionState *state) const;
+
+  // MoveHandToDiscard for every player of every game.
+  void MoveHandToDiscard();
+  // End-of-turn merge in every game: `player[g]`'s hand and the play area
+  // go to that player's discard pile.
+  void CleanupMerge(const int32_t *player);
+  // out[game * kNumPlayers + player] = TotalHandSize().
+  void HandSizes(int32_t *out) const;
+  // out[game * kNumPlayers + player] = coins from the basic treasures in hand.
+  void TreasureCoins(int32_t *out) const;
+
+private:
+  struct FreeDeleter {
+    void operator()(uint8_t *p) const { std::free(p); }
+  };
+  using Block = std::unique_ptr<uint8_t[], FreeDeleter>;
+  static Block AllocateRows(int rows);
+  static uint8_t *Row(uint8_t *block, int row) {
+    return block + static_cast<size_t>(row) * kCountRowBytes;
+  }
+  static const uint8_t *Row(const uint8_t *block, int row) {
+    return block + static_cast<size_t>(row) * kCountRowBytes;
+  }
+
+  int num_games_;
+  Block hand_;
+  Block discard_;
+  Block play_;
+  Block supply_;
+};
+
+} // namespace dominion
+} // namespace open_spiel
+
+#endif
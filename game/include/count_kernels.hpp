@@ -0,0 +1,71 @@
+#ifndef OPEN_SPIEL_GAMES_DOMINION_COUNT_KERNELS_H_
+#define OPEN_SPIEL_GAMES_DOMINION_COUNT_KERNELS_H_
+
+#include <cstdint>
+
+namespace open_spiel {
+namespace dominion {
+namespace count_kernels {
+
+// Kernels over the per-pile count arrays of the engine.
+//
+// Pile kernels work on one int array of kPileWidth counts (a hand, deck or
+// discard pile indexed by CardName). The implementation is picked once at
+// startup: AVX2 when the CPU has it (eight piles per instruction, the last
+// pile in scalar code, so the engine's arrays need no padding), otherwise a
+// portable scalar loop. Every implementation gives identical results.
+inline constexpr int kPileWidth = 33; // kNumSupplyPiles, checked in dominion.hpp
+
+struct PileKernels {
+  const char *isa;
+  // Sum of the counts (hand, deck or discard size).
+  int (*sum)(const int *counts);
+  // dst += src, src = 0 (hand to discard, discard into deck).
+  void (*move)(int *dst, int *src);
+  // Sum of counts[j] * weights[j] (coins from treasures in hand).
+  int (*dot)(const int *counts, const int *weights);
+};
+
+const PileKernels &ScalarPileKernels();
+// nullptr when the CPU or the compiler lacks AVX2.
+const PileKernels *Avx2PileKernels();
+// The implementation the engine uses.
+const PileKernels &ActivePileKernels();
+// Switches the engine to `kernels` (for tests and benchmarks).
+void SetActivePileKernels(const PileKernels &kernels);
+
+namespace internal {
+extern const PileKernels *active;
+} // namespace internal
+
+inline int SumPiles(const int *counts) { return internal::active->sum(counts); }
+inline void MovePiles(int *dst, int *src) { internal::active->move(dst, src); }
+inline int DotPiles(const int *counts, const int *weights) {
+  return internal::active->dot(counts, weights);
+}
+
+// Byte-sized counts for batches of games (see CountBatch): one row per pile
+// array, padded to a cache line. Padding bytes are zero and every kernel
+// keeps them zero, so kernels run over whole rows without a tail loop. No
+// pile holds more than 255 cards.
+inline constexpr int kCountRowBytes = 64;
+static_assert(kPileWidth <= kCountRowBytes, "count row too narrow");
+
+// Row kernels over `rows` consecutive, 64-byte-aligned count rows. The
+// element-wise ones are fixed-width loops that compilers vectorize; the
+// reductions use SSE2 where available.
+// dst[r] += src[r]; src[r] = 0 (MoveHandToDiscard).
+void MoveRows(uint8_t *dst, uint8_t *src, int rows);
+// dst[r] += a[r] + b[r]; a[r] = 0; b[r] = 0 (cleanup: hand and play area
+// into discard).
+void MergeRows(uint8_t *dst, uint8_t *a, uint8_t *b, int rows);
+// out[r] = sum of row r (TotalHandSize).
+void RowSums(const uint8_t *src, int rows, int32_t *out);
+// out[r] = sum over piles of src[r][j] * weights[j] (coins from treasures).
+void RowDots(const uint8_t *src, const uint8_t *weights, int rows, int32_t *out);
+
+} // namespace count_kernels
+} // namespace dominion
+} // namespace open_spiel
+
+#endif
@@ -2,14 +2,18 @@
 #define OPEN_SPIEL_GAMES_DOMINION_H_
 
 #include <array>
+#include <cstddef>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <random>
 #include <string>
 #include <vector>
 #include <deque>
+#include <functional>
 
 #include "cards.hpp"
+#include "count_kernels.hpp"
 
 #include "open_spiel/json/include/nlohmann/json.hpp"
 #include "open_spiel/spiel.h"
@@ -22,12 +26,39 @@ inline constexpr int kNumPlayers = 2;
 inline constexpr int kDominionMaxDistinctActions = 4096; // buffer for future action additions
 inline constexpr int kNumCardTypes = 33; // total card enumerators
 inline constexpr int kNumSupplyPiles = kNumCardTypes; // supply indexed by CardName
+static_assert(kNumSupplyPiles == count_kernels::kPileWidth, "pile kernel width");
+// Explicit-chance mode: a draw chance node never offers more outcomes than
+// this; larger draws are split into consecutive chance nodes.
+inline constexpr int kMaxDrawOutcomes = 1024;
+inline constexpr int kMaxDrawChunk = 16; // cards resolved by one chance node
+// Sampled mode: a shuffle chance node offers this many equally likely seed
+// outcomes; the chosen seed fixes the resulting deck order.
+inline constexpr int kNumShuffleSeeds = 1024;
+// Kingdom used when the "kingdom" game parameter is empty.
+inline constexpr std::array<CardName, 10> kDefaultKingdom = {
+    CardName::CARD_Cellar,      CardName::CARD_Market, CardName::CARD_Militia,
+    CardName::CARD_Moneylender, CardName::CARD_Moat,   CardName::CARD_Remodel,
+    CardName::CARD_Smithy,      CardName::CARD_Merchant, CardName::CARD_Workshop,
+    CardName::CARD_Mine};
 
 // Index conversion helpers
 inline int ToIndex(CardName card) { return static_cast<int>(card); }
 inline CardName ToCardName(int idx) { return static_cast<CardName>(idx); }
 inline bool IsValidPileIndex(int idx) { return idx >= 0 && idx < kNumSupplyPiles; }
 
+// splitmix64 step. Card orders derived from a seed go through this generator
+// so they are identical on every platform and standard library.
+inline uint64_t SplitMix64(uint64_t &state) {
+  uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+// Maps a random word to [0, n) using its high bits.
+inline int ScaleToRange(uint64_t r, int n) {
+  return static_cast<int>(((r >> 32) * static_cast<uint64_t>(n)) >> 32);
+}
+
 // Outcome of the game.
 enum class Outcome {
   kPlayer1,
@@ -50,70 +81,148 @@ enum class PendingChoice : int {
   SelectUpToCardsFromBoard = 4,
 };
 
+// ObservationBytes layout: one saturating uint8 per field, from the observing
+// player's point of view. Scalars are player, phase, actions, buys, coins,
+// whether the player is to move, own deck/discard size and opponent
+// hand/deck/discard size; then own hand, own discard, supply, play area and
+// the opponent's publicly owned cards, each as kNumSupplyPiles counts.
+inline constexpr int kObservationScalarBytes = 11;
+inline constexpr int kObservationBytes =
+    kObservationScalarBytes + 5 * kNumSupplyPiles;
+
+// Fixed-size information-set key. Two states that a player cannot tell apart
+// produce the same key; it is computed from counts and public history without
+// building strings, so search code can index infosets cheaply.
+struct InfosetKey {
+  uint64_t hi = 0;
+  uint64_t lo = 0;
+  bool operator==(const InfosetKey &other) const {
+    return hi == other.hi && lo == other.lo;
+  }
+  bool operator!=(const InfosetKey &other) const { return !(*this == other); }
+};
+
+struct InfosetKeyHash {
+  size_t operator()(const InfosetKey &k) const {
+    return static_cast<size_t>(k.lo ^ (k.hi * 0x9E3779B97F4A7C15ULL));
+  }
+};
+
+// Public card knowledge about one player, updated incrementally as cards move
+// in view of both players (buys, gains, trashes, plays, revealed discards).
+// Counts are per CardName; `owned` covers every zone, the other arrays cover
+// the cards whose zone is provably known. Anything left over is hidden in the
+// hand, deck, or unrevealed part of the discard pile.
+struct PublicCardTracker {
+  std::array<int, kNumSupplyPiles> owned{};
+  std::array<int, kNumSupplyPiles> in_play{};
+  std::array<int, kNumSupplyPiles> known_hand{};
+  std::array<int, kNumSupplyPiles> known_discard{};
+
+  void OnGainToDiscard(int j) { owned[j] += 1; known_discard[j] += 1; }
+  void OnGainToHand(int j) { owned[j] += 1; known_hand[j] += 1; }
+  void OnTrashFromHand(int j) {
+    if (owned[j] > 0) owned[j] -= 1;
+    LeaveHand(j);
+  }
+  void OnPlayFromHand(int j) { in_play[j] += 1; LeaveHand(j); }
+  void OnDiscardFromHand(int j) { known_discard[j] += 1; LeaveHand(j); }
+  // Hand and play area go to the discard pile; known cards stay known.
+  void OnCleanup() {
+    for (int j = 0; j < kNumSupplyPiles; ++j) {
+      known_discard[j] += in_play[j] + known_hand[j];
+      in_play[j] = 0;
+      known_hand[j] = 0;
+    }
+  }
+  // The discard pile becomes the (face-down) deck.
+  void OnReshuffle() { known_discard.fill(0); }
+  int Unlocated(int j) const {
+    return owned[j] - in_play[j] - known_hand[j] - known_discard[j];
+  }
+
+  NLOHMANN_DEFINE_TYPE_INTRUSIVE(PublicCardTracker, owned, in_play, known_hand,
+                                 known_discard)
+
+ private:
+  void LeaveHand(int j) {
+    if (known_hand[j] > 0) known_hand[j] -= 1;
+  }
+};
+
 // ObservationState holds references to a player's containers for observation.
-// Opponent-known counts remain aggregated to preserve imperfect information.
+// What the opponent can see of them is read from public_cards.
 struct ObservationState {
   std::array<int, kNumSupplyPiles> &player_hand_counts;
   std::vector<CardName> &player_deck;
+  std::array<int, kNumSupplyPiles> &player_deck_counts;
   std::array<int, kNumSupplyPiles> &player_discard_counts;
-  std::map<CardName, int> opponent_known_counts; // combined known set of opponent's hand+deck+discard
+  const PublicCardTracker &public_cards;
 
   ObservationState(std::array<int, kNumSupplyPiles> &hand_counts,
                    std::vector<CardName> &deck,
-                   std::array<int, kNumSupplyPiles> &discard_counts)
-      : player_hand_counts(hand_counts), player_deck(deck), player_discard_counts(discard_counts) {}
+                   std::array<int, kNumSupplyPiles> &deck_counts,
+                   std::array<int, kNumSupplyPiles> &discard_counts,
+                   const PublicCardTracker &public_cards)
+      : player_hand_counts(hand_counts), player_deck(deck),
+        player_deck_counts(deck_counts), player_discard_counts(discard_counts),
+        public_cards(public_cards) {}
   ObservationState(const ObservationState &other) = default;
 
-  std::map<CardName, int> KnownDeckCounts() const {
-    std::map<CardName, int> out;
-    for (auto cn : player_deck) out[cn] += 1;
+  std::array<int, kNumSupplyPiles> KnownDeckCounts() const {
+    std::array<int, kNumSupplyPiles> out = player_deck_counts;
+    for (auto cn : player_deck) out[static_cast<int>(cn)] += 1;
     return out;
   }
-  std::map<CardName, int> KnownDiscardCounts() const {
-    std::map<CardName, int> out;
-    for (int j = 0; j < kNumSupplyPiles; ++j) {
-      if (player_discard_counts[j] > 0) out[static_cast<CardName>(j)] = player_discard_counts[j];
-    }
-    return out;
+  const std::array<int, kNumSupplyPiles> &KnownDiscardCounts() const {
+    return player_discard_counts;
   }
 
 };
 
-// JSON-serializable contents used by StateStructs.
+// JSON-serializable contents used by StateStructs. Keys missing from the
+// input keep these defaults, so JSON written before a field existed still
+// loads; PlayerState rebuilds public_cards when that key is absent.
 struct DominionPlayerStructContents {
   std::vector<int> deck;
-  std::array<int, kNumSupplyPiles> hand_counts;
-  std::array<int, kNumSupplyPiles> discard_counts;
-  int pending_choice;
+  std::array<int, kNumSupplyPiles> deck_counts{};
+  uint64_t deck_rng = 0;
+  std::array<int, kNumSupplyPiles> hand_counts{};
+  std::array<int, kNumSupplyPiles> discard_counts{};
+  int pending_choice = 0;
   std::vector<EffectNodeStructContents> effect_queue;
-  NLOHMANN_DEFINE_TYPE_INTRUSIVE(
-      DominionPlayerStructContents, deck, hand_counts, discard_counts,
-      pending_choice, effect_queue)
+  PublicCardTracker public_cards;
+  NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(
+      DominionPlayerStructContents, deck, deck_counts, deck_rng, hand_counts,
+      discard_counts,
+      pending_choice, effect_queue, public_cards)
 };
 
 struct DominionStateStructContents {
-  int current_player;
-  int coins;
-  int turn_number;
-  int actions;
-  int buys;
-  int merchants_played;
-  int phase;
-  int last_player_to_go;
-  bool shuffle_pending;
-  bool shuffle_pending_end_of_turn;
-  int original_player_for_shuffle;
-  int pending_draw_count_after_shuffle;
-  std::array<int, kNumSupplyPiles> supply_piles;
-  std::array<int, kNumSupplyPiles> initial_supply_piles;
+  int current_player = 0;
+  int coins = 0;
+  int turn_number = 0;
+  int actions = 0;
+  int buys = 0;
+  int merchants_played = 0;
+  int phase = 0;
+  int last_player_to_go = 0;
+  bool shuffle_pending = false;
+  bool shuffle_pending_end_of_turn = false;
+  int original_player_for_shuffle = 0;
+  int pending_draw_count_after_shuffle = 0;
+  std::array<int, kNumPlayers> pending_draws{};
+  std::array<int, kNumSupplyPiles> supply_piles{};
+  std::array<int, kNumSupplyPiles> initial_supply_piles{};
   std::vector<int> play_area;
   std::vector<DominionPlayerStructContents> player_states;
-  int move_number;
-  NLOHMANN_DEFINE_TYPE_INTRUSIVE(
+  int move_number = 0;
+  NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(
       DominionStateStructContents, current_player, coins, turn_number, actions,
       buys, merchants_played, phase, last_player_to_go, shuffle_pending,
       shuffle_pending_end_of_turn, original_player_for_shuffle,
-      pending_draw_count_after_shuffle, supply_piles, initial_supply_piles,
+      pending_draw_count_after_shuffle, pending_draws, supply_piles,
+      initial_supply_piles,
       play_area, player_states, move_number)
 };
 
@@ -136,7 +245,12 @@ struct DominionStateStruct : public StateStruct,
 };
 
 struct PlayerState {
+  // Draw pile, back = top. In counts-deck mode this holds only cards known to
+  // be on top; the unordered rest lives in deck_counts_ and is sampled at draw
+  // time from deck_rng_, which the last shuffle seeded.
   std::vector<CardName> deck_;
+  std::array<int, kNumSupplyPiles> deck_counts_{};
+  uint64_t deck_rng_ = 0;
   std::array<int, kNumSupplyPiles> hand_counts_{};
   std::array<int, kNumSupplyPiles> discard_counts_{};
   std::vector<Action> history_;
@@ -144,15 +258,36 @@ struct PlayerState {
   // Effect-specific state moved into nodes; PlayerState retains only choice
   // type and the effect queue.
   std::deque<std::unique_ptr<EffectNode>> effect_queue; // FIFO of pending effects
+  PublicCardTracker public_cards_; // what the opponent can prove about our cards
   std::unique_ptr<ObservationState> obs_state; // per-player observation state
 
   PlayerState() = default;
   PlayerState(const PlayerState &other)
       : deck_(other.deck_),
+        deck_counts_(other.deck_counts_),
+        deck_rng_(other.deck_rng_),
         hand_counts_(other.hand_counts_),
         discard_counts_(other.discard_counts_),
         history_(other.history_),
-        pending_choice(other.pending_choice) {
+        pending_choice(other.pending_choice),
+        public_cards_(other.public_cards_) {
+    CloneEffectQueue(other);
+    ResetObsState();
+  }
+  // Copy assignment that keeps this object's buffers and observation view.
+  void AssignFrom(const PlayerState &other) {
+    deck_ = other.deck_;
+    deck_counts_ = other.deck_counts_;
+    deck_rng_ = other.deck_rng_;
+    hand_counts_ = other.hand_counts_;
+    discard_counts_ = other.discard_counts_;
+    history_ = other.history_;
+    pending_choice = other.pending_choice;
+    public_cards_ = other.public_cards_;
+    CloneEffectQueue(other);
+    if (!obs_state) ResetObsState();
+  }
+  void CloneEffectQueue(const PlayerState &other) {
     effect_queue.clear();
     for (const auto &node_ptr : other.effect_queue) {
       if (node_ptr) {
@@ -163,14 +298,13 @@ struct PlayerState {
         effect_queue.push_back(nullptr);
       }
     }
-    obs_state = std::make_unique<ObservationState>(hand_counts_, deck_, discard_counts_);
   }
   explicit PlayerState(const nlohmann::json &json) {
-    DominionPlayerStateStruct ss(json.dump());
-    LoadFromStruct(ss);
+    LoadFromStruct(json.get<DominionPlayerStructContents>());
+    if (!json.contains("public_cards")) RebuildPublicCards(nullptr);
   }
 
-  void LoadFromStruct(const DominionPlayerStateStruct &ss) {
+  void LoadFromStruct(const DominionPlayerStructContents &ss) {
     deck_.clear();
     hand_counts_.fill(0);
     discard_counts_.fill(0);
@@ -179,34 +313,64 @@ struct PlayerState {
     effect_queue.clear();
     deck_.reserve(ss.deck.size());
     for (int v : ss.deck) deck_.push_back(static_cast<CardName>(v));
+    deck_counts_ = ss.deck_counts;
+    deck_rng_ = ss.deck_rng;
     hand_counts_ = ss.hand_counts;
     discard_counts_ = ss.discard_counts;
+    public_cards_ = ss.public_cards;
     pending_choice = static_cast<PendingChoice>(ss.pending_choice);
     for (const auto &ens : ss.effect_queue) {
       auto node = EffectNodeFromStruct(ens, pending_choice);
       if (node) effect_queue.push_back(std::move(node));
     }
-    obs_state = std::make_unique<ObservationState>(hand_counts_, deck_, discard_counts_);
+    ResetObsState();
+  }
+
+  // For JSON that predates public_cards: every card we hold (plus our cards in
+  // play, if given) counts as owned, and none of them as located.
+  void RebuildPublicCards(const std::vector<CardName> *play_area) {
+    public_cards_ = PublicCardTracker();
+    auto &owned = public_cards_.owned;
+    for (int j = 0; j < kNumSupplyPiles; ++j)
+      owned[j] = deck_counts_[j] + hand_counts_[j] + discard_counts_[j];
+    for (auto cn : deck_) owned[static_cast<int>(cn)] += 1;
+    if (play_area) {
+      for (auto cn : *play_area) {
+        owned[static_cast<int>(cn)] += 1;
+        public_cards_.in_play[static_cast<int>(cn)] += 1;
+      }
+    }
   }
 
   // JSON struct factory.
   std::unique_ptr<StateStruct> ToStruct() const {
+    auto ss = std::make_unique<DominionPlayerStateStruct>();
+    static_cast<DominionPlayerStructContents &>(*ss) = ToContents();
+    return ss;
+  }
+  DominionPlayerStructContents ToContents() const {
     DominionPlayerStructContents contents;
     contents.deck.clear();
     contents.deck.reserve(deck_.size());
     for (auto cn : deck_) contents.deck.push_back(static_cast<int>(cn));
+    contents.deck_counts = deck_counts_;
+    contents.deck_rng = deck_rng_;
     contents.hand_counts = hand_counts_;
     contents.discard_counts = discard_counts_;
+    contents.public_cards = public_cards_;
     // history_ not included in JSON struct.
     contents.pending_choice = static_cast<int>(pending_choice);
     contents.effect_queue.clear();
     for (const auto &node_ptr : effect_queue) {
       if (node_ptr) contents.effect_queue.push_back(EffectNodeToStruct(*node_ptr));
     }
-    auto ss = std::make_unique<DominionPlayerStateStruct>();
-    static_cast<DominionPlayerStructContents&>(*ss) = contents;
-    return ss;
+    return contents;
+  }
+  void ResetObsState() {
+    obs_state = std::make_unique<ObservationState>(
+        hand_counts_, deck_, deck_counts_, discard_counts_, public_cards_);
   }
+
   // No copy-assignment: deep copy supported via copy constructor; assignment is
   // intentionally omitted.
 
@@ -221,13 +385,7 @@ struct PlayerState {
     return hand_counts_[static_cast<int>(card)];
   }
 
-  int TotalHandSize() const {
-    int total = 0;
-    for (int count : hand_counts_) {
-      total += count;
-    }
-    return total;
-  }
+  int TotalHandSize() const { return count_kernels::SumPiles(hand_counts_.data()); }
 
   void AddToHand(CardName card, int count = 1) {
     hand_counts_[static_cast<int>(card)] += count;
@@ -243,20 +401,42 @@ struct PlayerState {
   }
 
   void MoveHandToDiscard() {
-    for (int j = 0; j < kNumSupplyPiles; ++j) {
-      discard_counts_[j] += hand_counts_[j];
-      hand_counts_[j] = 0;
-    }
+    count_kernels::MovePiles(discard_counts_.data(), hand_counts_.data());
+  }
+
+  int DeckSize() const {
+    return static_cast<int>(deck_.size()) + count_kernels::SumPiles(deck_counts_.data());
   }
 
-  int TotalDiscardSize() const {
-    int total = 0;
-    for (int count : discard_counts_) {
-      total += count;
+  // Deck contents by card type, ignoring order.
+  std::array<int, kNumSupplyPiles> DeckCounts() const {
+    std::array<int, kNumSupplyPiles> out = deck_counts_;
+    for (CardName cn : deck_) out[static_cast<int>(cn)] += 1;
+    return out;
+  }
+
+  // Removes the top card and returns its index: a known top card if any,
+  // otherwise one sampled uniformly from deck_counts_. Deck must be non-empty.
+  int DrawTopCard() {
+    if (!deck_.empty()) {
+      int j = static_cast<int>(deck_.back());
+      deck_.pop_back();
+      return j;
+    }
+    int total = count_kernels::SumPiles(deck_counts_.data());
+    int r = ScaleToRange(SplitMix64(deck_rng_), total);
+    for (int j = 0; j < kNumSupplyPiles; ++j) {
+      if (r < deck_counts_[j]) {
+        deck_counts_[j] -= 1;
+        return j;
+      }
+      r -= deck_counts_[j];
     }
-    return total;
+    SpielFatalError("DrawTopCard: empty deck");
   }
 
+  int TotalDiscardSize() const { return count_kernels::SumPiles(discard_counts_.data()); }
+
   void AddToDiscard(CardName card, int count = 1) {
     discard_counts_[static_cast<int>(card)] += count;
   }
@@ -280,26 +460,92 @@ struct PlayerState {
 
 };
 
+// A move the engine applied by itself because it was the only legal one (see
+// DominionState::MaybeAutoApplySingleAction). Forced moves are not part of
+// History(): `move` is the History() index of the action being applied when
+// it was forced and `probe` numbers the single-action checks made while
+// applying that action, so a replay can apply it at the same point unchecked.
+struct ForcedMove {
+  uint32_t move = 0;
+  uint32_t probe = 0;
+  Action action = kInvalidAction;
+};
+
 class DominionState : public State {
 public:
   explicit DominionState(std::shared_ptr<const Game> game);
   DominionState(std::shared_ptr<const Game> game, const nlohmann::json &json);
+  // Loads a state written by SerializeBinary().
+  DominionState(std::shared_ptr<const Game> game, const char *data, size_t size);
 
   Player CurrentPlayer() const override;
   std::vector<Action> LegalActions() const override;
+  // Same actions written into `out` (cleared first), so callers that reuse a
+  // buffer allocate nothing once it has grown.
+  void LegalActions(std::vector<Action> *out) const;
   std::string ActionToString(Player player, Action action_id) const override;
   std::string ObservationString(int player) const override;
+  // Fixed-size byte encoding of the same view (layout above kObservationBytes).
+  void ObservationBytes(int player, uint8_t *out) const;
   std::string InformationStateString(int player) const override;
+  // Binary counterpart of InformationStateString: covers the same view
+  // (own hand, public sizes, supply, play area, last action) plus the pending
+  // effect state that determines this player's legal actions.
+  InfosetKey InformationStateKey(int player) const;
+  // Cards of `player` that both players can account for from public play.
+  const PublicCardTracker &PublicCards(int player) const {
+    return player_states_[player].public_cards_;
+  }
   std::string ToString() const override;
   bool IsTerminal() const override;
   std::vector<double> Returns() const override;
   std::unique_ptr<State> Clone() const override;
+  // Overwrites this state with `other`, reusing this state's vectors: the
+  // allocation-free counterpart of Clone() for search code that restarts one
+  // scratch state many times. Only pending effect nodes are reallocated.
+  void CopyFrom(const DominionState &other);
+  // Samples a full state consistent with player_id's information: own hand and
+  // discard are kept, own deck order is redrawn, and the opponent's hidden
+  // cards (hand, deck and discard minus what is publicly located) are
+  // redistributed over those three piles at unchanged sizes. Opponent cards
+  // publicly known to be in hand or discard stay there.
+  std::unique_ptr<State> ResampleFromInfostate(
+      int player_id, std::function<double()> rng) const override;
+  // In-place form of ResampleFromInfostate for callers that reuse one state
+  // across many determinizations. rng must return uniform values in [0, 1).
+  void ResampleHiddenCards(int player_id, const std::function<double()> &rng);
   ActionsAndProbs ChanceOutcomes() const override;
+  // Forced moves applied since the start of History(), in order.
+  const std::vector<ForcedMove> &ForcedMoves() const { return forced_moves_; }
+  // Fast-forwards through a recorded game: `actions` continue this state's
+  // History() and `forced` is the ForcedMoves() of the game they come from.
+  // Forced moves are applied from the record, so no step calls LegalActions()
+  // to look for them; the actions are trusted, not validated.
+  void ReplayHistory(const Action *actions, size_t n, const std::vector<ForcedMove> &forced);
+  void ReplayHistory(const std::vector<Action> &actions, const std::vector<ForcedMove> &forced) {
+    ReplayHistory(actions.data(), actions.size(), forced);
+  }
   std::unique_ptr<StateStruct> ToStruct() const override;
   std::string Serialize() const override;
-
-  // Draw n cards for player, shuffling discard into deck when needed.
+  // Compact binary counterpart of Serialize() (layout in serialization.hpp).
+  // Only loads into a game with the same explicit_chance / counts_deck /
+  // opening_chance parameters.
+  std::string SerializeBinary() const;
+  // Overwrites this state in place; history is cleared as with JSON loads.
+  void DeserializeBinary(const std::string &bytes);
+
+  // Draw n cards for player, shuffling discard into deck when needed. In
+  // explicit-chance mode the draw is deferred to chance nodes instead.
   void DrawCardsFor(int player, int n);
+  // Explicit-chance mode: each draw is a chance node over the distinct
+  // multisets of card types that can be drawn. Implies counts-deck storage.
+  bool ExplicitChance() const { return explicit_chance_; }
+  // Counts-deck mode: draw piles are count vectors (PlayerState::deck_counts_)
+  // and shuffles merge counts instead of permuting cards.
+  bool CountsDeck() const { return counts_deck_; }
+  // Opening-chance mode: starting decks begin in the discard pile, so each
+  // opening hand is dealt through a shuffle chance node.
+  bool OpeningChance() const { return opening_chance_; }
 
   Player current_player_ = 0;
   int coins_ = 0;
@@ -328,15 +574,43 @@ protected:
   // selections.
   void MaybeAutoAdvanceToBuyPhase();
   // Optimization: when not at chance node, if LegalActions returns a single
-  // action, auto-apply it and continue until branching occurs.
+  // action, auto-apply it and continue until branching occurs. Forced moves
+  // are not recorded in History() but in ForcedMoves(); replaying History()
+  // with ApplyAction re-derives them. Inside ReplayHistory the recorded ones
+  // are applied instead.
   void MaybeAutoApplySingleAction();
   private:
+  // Continues a Throne Room whose doubled card opened a selection, once that
+  // selection has resolved and any draws it caused have been dealt.
+  void MaybeResumeThroneRoom();
   void ApplyMerchantBonusOnSilverPlay();
+  // Explicit-chance draw bookkeeping.
+  int DrawPlayer() const;
+  int DrawChunkSize(int player) const;
+  void SettlePendingDraws();
+  bool DecodeDrawOutcome(Action action_id,
+                         std::array<int, kNumSupplyPiles> *draw) const;
+  void ApplyDrawOutcome(Action action_id);
+  void DealOpeningHands();
+  void LoadBinary(const char *data, size_t size);
+  bool explicit_chance_ = false;
+  bool counts_deck_ = false;
+  bool opening_chance_ = false;
+  std::array<int, kNumPlayers> pending_draws_{};
   // Sampled stochastic shuffle state (internal-only).
   bool shuffle_pending_ = false;
   bool shuffle_pending_end_of_turn_ = false;
   int original_player_for_shuffle_ = -1;
   int pending_draw_count_after_shuffle_ = 0;
+  std::vector<ForcedMove> forced_moves_;
+  // Single-action checks made so far while applying History() entry
+  // probe_move_ (see ForcedMove::probe).
+  uint32_t probe_move_ = 0;
+  uint32_t probes_ = 0;
+  // Set only inside ReplayHistory: the recorded forced moves and the next
+  // one to apply.
+  const std::vector<ForcedMove> *replay_forced_ = nullptr;
+  size_t replay_next_ = 0;
 
   friend struct DominionTestHarness; // test-only accessor
   friend std::vector<Action>
@@ -358,9 +632,20 @@ public:
   int MaxChanceOutcomes() const override;
   std::unique_ptr<State> NewInitialState(const nlohmann::json &json) const override;
   std::unique_ptr<State> DeserializeState(const std::string &str) const override;
+  // Counterpart of DominionState::SerializeBinary().
+  std::unique_ptr<State> DeserializeStateBinary(const std::string &bytes) const;
 
+  bool ExplicitChance() const { return explicit_chance_; }
+  bool CountsDeck() const { return counts_deck_; }
+  bool OpeningChance() const { return opening_chance_; }
+  // Kingdom piles of the supply (10 cards each), from the "kingdom" parameter.
+  const std::vector<CardName> &Kingdom() const { return kingdom_; }
 
 private:
+  bool explicit_chance_ = false;
+  bool counts_deck_ = false;
+  bool opening_chance_ = false;
+  std::vector<CardName> kingdom_;
 };
 } // namespace dominion
 } // namespace open_spiel
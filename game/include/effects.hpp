@@ -23,6 +23,9 @@ public:
   virtual ~EffectNode() = default;
   // Polymorphic deep copy, used in PlayerState copy construction.
   virtual std::unique_ptr<EffectNode> clone() const = 0;
+  // The card whose effect this is; stable across builds, and the "kind"
+  // written to JSON.
+  virtual CardName card() const = 0;
   std::function<bool(DominionState&, int, Action)> on_action;
   bool enforce_ascending = false;
   virtual struct HandSelectionStruct* hand_selection() { return nullptr; }
@@ -92,6 +95,7 @@ class CellarEffectNode : public CloneableEffectNode<CellarEffectNode> {
 public:
   CellarEffectNode() = default;
   CellarEffectNode(PendingChoice choice, const HandSelectionStruct* hs = nullptr);
+  CardName card() const override;
   HandSelectionStruct* hand_selection() override { return &hand_; }
   const HandSelectionStruct* hand_selection() const override { return &hand_; }
 private:
@@ -103,6 +107,7 @@ class ChapelEffectNode : public CloneableEffectNode<ChapelEffectNode> {
 public:
   ChapelEffectNode() = default;
   ChapelEffectNode(PendingChoice choice, const HandSelectionStruct* hs = nullptr);
+  CardName card() const override;
   HandSelectionStruct* hand_selection() override { return &hand_; }
   const HandSelectionStruct* hand_selection() const override { return &hand_; }
 private:
@@ -114,6 +119,7 @@ class RemodelTrashEffectNode : public CloneableEffectNode<RemodelTrashEffectNode
 public:
   RemodelTrashEffectNode() = default;
   RemodelTrashEffectNode(PendingChoice choice, const HandSelectionStruct* hs = nullptr);
+  CardName card() const override;
   HandSelectionStruct* hand_selection() override { return &hand_; }
   const HandSelectionStruct* hand_selection() const override { return &hand_; }
 private:
@@ -125,6 +131,7 @@ class MilitiaEffectNode : public CloneableEffectNode<MilitiaEffectNode> {
 public:
   MilitiaEffectNode() = default;
   MilitiaEffectNode(PendingChoice choice, const HandSelectionStruct* hs = nullptr);
+  CardName card() const override;
   HandSelectionStruct* hand_selection() override { return &hand_; }
   const HandSelectionStruct* hand_selection() const override { return &hand_; }
 private:
@@ -137,6 +144,7 @@ class ThroneRoomEffectNode : public CloneableEffectNode<ThroneRoomEffectNode> {
 public:
   ThroneRoomEffectNode() = default;
   explicit ThroneRoomEffectNode(int depth);
+  CardName card() const override;
   int throne_depth() const { return throne_select_depth_; }
   void increment_throne_depth() { ++throne_select_depth_; }
   void decrement_throne_depth() { if (throne_select_depth_ > 0) --throne_select_depth_; }
@@ -148,11 +156,25 @@ public:
   void ContinueOrFinish(DominionState& state, int player);
   // Clear pending choice and finish the effect.
   void FinishSelection(DominionState& state, int player);
+  // Pile of the card being played twice (-1 between picks) and how many of
+  // its plays are still to come.
+  int doubling_pile() const { return doubling_pile_; }
+  int plays_left() const { return plays_left_; }
+  void set_doubling(int pile, int plays_left) {
+    doubling_pile_ = pile;
+    plays_left_ = plays_left;
+  }
+  // Plays the picked card until its plays run out, then continues the chain.
+  // A play that opens its own selection (Cellar, Chapel, ...) puts this node
+  // behind that selection; DominionState resumes it once the selection ends.
+  void PlayDoubled(DominionState& state, int player);
   HandSelectionStruct* hand_selection() override { return &hand_; }
   const HandSelectionStruct* hand_selection() const override { return &hand_; }
 private:
   HandSelectionStruct hand_;
   int throne_select_depth_ = 0;
+  int doubling_pile_ = -1;
+  int plays_left_ = 0;
 };
 
 // Workshop: gain a card from the supply up to cost 4.
@@ -160,6 +182,7 @@ class WorkshopEffectNode : public CloneableEffectNode<WorkshopEffectNode> {
 public:
   WorkshopEffectNode() = default;
   explicit WorkshopEffectNode(int max_cost) : gain_(max_cost) {}
+  CardName card() const override;
   GainFromBoardStruct* gain_from_board() override { return &gain_; }
   const GainFromBoardStruct* gain_from_board() const override { return &gain_; }
 private:
@@ -171,6 +194,7 @@ class RemodelGainEffectNode : public CloneableEffectNode<RemodelGainEffectNode>
 public:
   RemodelGainEffectNode() = default;
   explicit RemodelGainEffectNode(int max_cost) : gain_(max_cost) {}
+  CardName card() const override;
   GainFromBoardStruct* gain_from_board() override { return &gain_; }
   const GainFromBoardStruct* gain_from_board() const override { return &gain_; }
 private:
@@ -183,12 +207,16 @@ struct EffectNodeStructContents {
   int gain_max_cost = 0;
   bool gain_only_treasure = false;
   int throne_select_depth = 0;
-  NLOHMANN_DEFINE_TYPE_INTRUSIVE(EffectNodeStructContents,
-                                 kind,
-                                 hand,
-                                 gain_max_cost,
-                                 gain_only_treasure,
-                                 throne_select_depth)
+  int throne_doubling_pile = -1;
+  int throne_plays_left = 0;
+  NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(EffectNodeStructContents,
+                                              kind,
+                                              hand,
+                                              gain_max_cost,
+                                              gain_only_treasure,
+                                              throne_select_depth,
+                                              throne_doubling_pile,
+                                              throne_plays_left)
 };
 
 EffectNodeStructContents EffectNodeToStruct(const EffectNode& node);
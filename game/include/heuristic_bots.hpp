@@ -0,0 +1,58 @@
+#ifndef OPEN_SPIEL_GAMES_DOMINION_HEURISTIC_BOTS_H_
+#define OPEN_SPIEL_GAMES_DOMINION_HEURISTIC_BOTS_H_
+
+#include <memory>
+#include <string>
+
+#include "dominion.hpp"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_bots.h"
+
+namespace open_spiel {
+namespace dominion {
+
+// Fixed-strategy players for baselines, evaluation and rollouts.
+//
+// Decisions are read off the state's count arrays (hand, deck, discard,
+// play area, supply) against a per-card table built once, with no string
+// formatting. Every strategy shares the same money and endgame rules:
+//   buy Province at 8; at 6-7 Gold, or Duchy once 4 or fewer Provinces are
+//   left; at 5 Silver, or Duchy at 5 or fewer; at 3-4 Silver, or Estate at
+//   2 or fewer; at 2 Estate at 3 or fewer; never Copper or Curse.
+// The variants add one kingdom card to that plan:
+//   kBigMoneySmithy:  Smithy at 4-5, about one per 12 cards owned (max 3).
+//   kBigMoneyMilitia: Militia at 4-5, up to 2.
+//   kBigMoneyWitch:   Witch at 5, and over Gold while none is owned; up to 2.
+//   kChapelEngine:    one Chapel opening at 2-4, Laboratory at 5 while more
+//                     than 4 Provinces are left; Chapel trashes Curses,
+//                     Estates (until the last 2 Provinces) and Coppers while
+//                     at least kChapelMoneyFloor coins of treasure remain.
+// A card missing from the kingdom is never bought; the plan falls back to
+// money. Effect choices (Militia discards, Cellar, Throne Room, Remodel,
+// Workshop, Mine) use the same card values: discard and trash junk first,
+// gain what the buy rules would buy.
+enum class HeuristicStrategy {
+  kBigMoney,
+  kBigMoneySmithy,
+  kBigMoneyMilitia,
+  kBigMoneyWitch,
+  kChapelEngine,
+};
+
+inline constexpr int kChapelMoneyFloor = 6;
+
+// "bigmoney", "bm_smithy", "bm_militia", "bm_witch", "chapel".
+const char *HeuristicStrategyName(HeuristicStrategy strategy);
+// False for an unknown name.
+bool ParseHeuristicStrategy(const std::string &name, HeuristicStrategy *strategy);
+
+// The strategy's move for the player to move at a decision node.
+Action HeuristicAction(const DominionState &state, HeuristicStrategy strategy);
+
+// Deterministic Bot wrapper around HeuristicAction.
+std::unique_ptr<Bot> MakeHeuristicBot(HeuristicStrategy strategy);
+
+} // namespace dominion
+} // namespace open_spiel
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef OPEN_SPIEL_GAMES_DOMINION_HISTOGRAM_H_
+#define OPEN_SPIEL_GAMES_DOMINION_HISTOGRAM_H_
+
+#include <array>
+#include <cstdint>
+
+namespace open_spiel {
+namespace dominion {
+
+// Log-linear (HDR-style) histogram of non-negative integer samples.
+//
+// Values below kSubBuckets are counted exactly; above that each power of two
+// is split into kSubBuckets equal buckets, so a bucket spans at most 1/16 of
+// its lower bound and percentiles are reported within ~6%. The full uint64
+// range fits in a fixed array, and histograms with the same layout merge by
+// adding counts, so per-thread histograms can be summed at report time.
+class LogLinearHistogram {
+public:
+  static constexpr int kSubBucketBits = 4;
+  static constexpr int kSubBuckets = 1 << kSubBucketBits;
+  static constexpr int kNumBuckets = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+  static int BucketIndex(uint64_t value) {
+    if (value < kSubBuckets) return static_cast<int>(value);
+    int shift = 63 - __builtin_clzll(value) - kSubBucketBits;
+    return (shift + 1) * kSubBuckets + static_cast<int>((value >> shift) & (kSubBuckets - 1));
+  }
+  // Smallest and largest value counted by a bucket.
+  static uint64_t BucketLow(int index);
+  static uint64_t BucketHigh(int index);
+
+  void Record(uint64_t value) { RecordCount(value, 1); }
+  void RecordCount(uint64_t value, uint64_t count);
+  // Adds the counts of one bucket (as stored by a concurrent recorder).
+  void AddBucket(int index, uint64_t count);
+  void Merge(const LogLinearHistogram &other);
+  void Clear() { *this = LogLinearHistogram(); }
+
+  uint64_t Count() const { return count_; }
+  uint64_t BucketCount(int index) const { return counts_[index]; }
+  // Bounds of the non-empty buckets; 0 when empty.
+  uint64_t Min() const;
+  uint64_t Max() const;
+  // Upper bound of the bucket holding the sample of rank ceil(p/100 * n);
+  // 0 when empty.
+  uint64_t ValueAtPercentile(double percentile) const;
+
+private:
+  std::array<uint64_t, kNumBuckets> counts_{};
+  uint64_t count_ = 0;
+};
+
+} // namespace dominion
+} // namespace open_spiel
+
+#endif
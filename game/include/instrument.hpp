@@ -0,0 +1,156 @@
+#ifndef OPEN_SPIEL_GAMES_DOMINION_INSTRUMENT_H_
+#define OPEN_SPIEL_GAMES_DOMINION_INSTRUMENT_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "open_spiel/spiel.h"
+
+#include "histogram.hpp"
+
+#if defined(DOMINION_INSTRUMENT) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#elif defined(DOMINION_INSTRUMENT)
+#include <chrono>
+#endif
+
+namespace open_spiel {
+namespace dominion {
+namespace instrument {
+
+// Opt-in hot-path probes. Configure with -DDOMINION_INSTRUMENT=ON to compile
+// them in; otherwise DOMINION_PROBE_SCOPE / DOMINION_PROBE_COUNT expand to
+// nothing and the report functions return zeros.
+//
+// Each thread accumulates into its own block of counters (single writer,
+// relaxed atomics, no locks); Snapshot() sums every block ever registered, so
+// totals of finished threads are kept. Scoped timers are inclusive: an
+// ApplyAction probe also covers the forced moves, draws and effect handlers
+// it runs. Every scoped timer also feeds a per-thread log-linear latency
+// histogram so tails (a Throne Room on a Throne Room, a reshuffling Cellar)
+// are visible next to the mean.
+enum class Probe : int {
+  kApplyPlay,
+  kApplyDiscardSelect,
+  kApplyTrashSelect,
+  kApplyThroneFinish,
+  kApplyEndActions,
+  kApplyBuy,
+  kApplyEndBuy,
+  kApplyGainSelect,
+  kApplyChance,
+  kLegalActions,
+  kPendingEffectLegalActions,
+  kDrawCardsFor,
+  kShuffle,
+  kClone,
+  kCopyFrom,
+  kEffectHandler,
+  kSerializeJson,
+  kDeserializeJson,
+  kSerializeBinary,
+  kDeserializeBinary,
+  kNumProbes,
+};
+inline constexpr int kNumProbes = static_cast<int>(Probe::kNumProbes);
+
+const char *ProbeName(Probe probe);
+// ApplyAction probe for an action id, by action kind.
+Probe ApplyProbe(Action action_id);
+
+struct ProbeTotals {
+  uint64_t count = 0;
+  uint64_t ticks = 0; // TSC cycles on x86, nanoseconds elsewhere
+};
+
+constexpr bool Enabled() {
+#ifdef DOMINION_INSTRUMENT
+  return true;
+#else
+  return false;
+#endif
+}
+// Unit of ProbeTotals::ticks: "cycles" or "ns".
+const char *TickUnit();
+
+std::array<ProbeTotals, kNumProbes> Snapshot();
+// Per-call latency of a scoped probe in ticks, merged over every thread.
+// Empty for count-only probes and when instrumentation is off.
+LogLinearHistogram Histogram(Probe probe);
+// Zeroes every thread's counters. Increments racing with Reset may survive it.
+void Reset();
+// {"enabled", "tick_unit", "probes": {name: {"count", "ticks", "ticks_per_call",
+// "p50", "p99", "p999", "max"}}}; percentiles are in ticks, 0 if not timed.
+std::string ReportJson();
+// One line per probe that fired, sorted by total ticks, with p50/p99/p999.
+std::string ReportText();
+
+#ifdef DOMINION_INSTRUMENT
+struct ThreadProbes {
+  std::array<std::atomic<uint64_t>, kNumProbes> count{};
+  std::array<std::atomic<uint64_t>, kNumProbes> ticks{};
+  std::array<std::array<std::atomic<uint64_t>, LogLinearHistogram::kNumBuckets>, kNumProbes>
+      latency{};
+  ThreadProbes *next = nullptr;
+};
+
+// This thread's block, registered on first use.
+ThreadProbes &LocalProbes();
+
+inline uint64_t ReadTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+#endif
+}
+
+// Only the owning thread writes its block, so load + store is enough.
+inline void Bump(std::atomic<uint64_t> &cell, uint64_t v) {
+  cell.store(cell.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+}
+
+inline void Count(Probe probe) {
+  Bump(LocalProbes().count[static_cast<int>(probe)], 1);
+}
+
+class ScopedProbe {
+public:
+  explicit ScopedProbe(Probe probe) : probe_(probe), start_(ReadTicks()) {}
+  ~ScopedProbe() {
+    uint64_t elapsed = ReadTicks() - start_;
+    ThreadProbes &tp = LocalProbes();
+    int p = static_cast<int>(probe_);
+    Bump(tp.count[p], 1);
+    Bump(tp.ticks[p], elapsed);
+    Bump(tp.latency[p][LogLinearHistogram::BucketIndex(elapsed)], 1);
+  }
+  ScopedProbe(const ScopedProbe &) = delete;
+  ScopedProbe &operator=(const ScopedProbe &) = delete;
+
+private:
+  Probe probe_;
+  uint64_t start_;
+};
+
+#define DOMINION_PROBE_CONCAT_(a, b) a##b
+#define DOMINION_PROBE_CONCAT(a, b) DOMINION_PROBE_CONCAT_(a, b)
+#define DOMINION_PROBE_SCOPE(probe)                                          \
+  ::open_spiel::dominion::instrument::ScopedProbe DOMINION_PROBE_CONCAT(     \
+      dominion_probe_, __LINE__)(probe)
+#define DOMINION_PROBE_COUNT(probe) ::open_spiel::dominion::instrument::Count(probe)
+#else
+#define DOMINION_PROBE_SCOPE(probe) static_cast<void>(0)
+#define DOMINION_PROBE_COUNT(probe) static_cast<void>(0)
+#endif
+
+} // namespace instrument
+} // namespace dominion
+} // namespace open_spiel
+
+#endif
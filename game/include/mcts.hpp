@@ -0,0 +1,170 @@
+#ifndef OPEN_SPIEL_GAMES_DOMINION_MCTS_H_
+#define OPEN_SPIEL_GAMES_DOMINION_MCTS_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "actions.hpp"
+#include "dominion.hpp"
+#include "heuristic_bots.hpp"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_bots.h"
+
+namespace open_spiel {
+namespace dominion {
+
+// Monte Carlo tree search specialized for Dominion.
+//
+// Tree nodes live in one arena allocated to max_nodes when the search is
+// created and refer to each other by index; nodes created by one expansion
+// are adjacent. A node's children are a contiguous block of node indices in
+// a second arena (the edges), so selection scans one short array. Nothing
+// is freed during a search.
+//
+// Chance outcomes are not tree nodes: each simulation copies the root into
+// a scratch state with DominionState::CopyFrom (no allocation once its
+// buffers have grown), optionally redeals the cards the searching player
+// cannot see (ResampleHiddenCards), and samples chance outcomes as it goes
+// (shuffles included). A node is therefore reached under different draws
+// with different legal actions: selection only considers the children legal
+// in the current simulation, and a legal action without a child is added to
+// the node's edge block (which is copied to the end of the edge arena if it
+// cannot grow in place). Every edge records the player who chose it, and its
+// value is kept from that player's point of view, so decisions taken out of
+// turn (an opponent discarding to Militia) need no special casing.
+//
+// Parallel search (num_threads > 1): the threads share one tree, each with
+// its own scratch state and random stream. Node statistics are atomics
+// updated without locks; a node's edge block is published with one atomic
+// word, and only its growth is serialized by a per-node flag that other
+// threads never wait on (they select among the existing children, or
+// evaluate the node as a leaf). Simulations in flight through an edge count
+// as virtual losses, which steers the other threads to different lines.
+// Results then depend on thread timing; with one thread a search is
+// reproducible from config.seed.
+//
+// Tree reuse: Search() on a state whose history extends the previous root's
+// follows the new player actions down the tree, and the subtree found there
+// is compacted to the front of a second pair of arenas and becomes the new
+// root.
+struct MctsConfig {
+  int simulations = 400;
+  double uct_c = 1.4;
+  // Arena capacities; once either is full, leaves are evaluated without
+  // expanding. Relocated edge blocks stay in the edge arena until the next
+  // compaction, so it needs more room than the nodes (0: 2 * max_nodes).
+  int max_nodes = 1 << 17;
+  int64_t max_edges = 0;
+  // Redeal hidden cards (opponent hand and deck, own deck order) per
+  // simulation. Off: search the true state (perfect information).
+  bool determinize = true;
+  bool reuse_tree = true;
+  // Threads searching the tree: the caller plus num_threads - 1 started per
+  // Search() call.
+  int num_threads = 1;
+  // Each simulation in flight through an edge counts as a visit that
+  // returned -virtual_loss for the edge's player.
+  double virtual_loss = 1.0;
+  // Leaf evaluation without an evaluator: play to the end with
+  // `rollout_strategy` (uniform random moves if !heuristic_rollout), at most
+  // max_rollout_moves moves; capped rollouts count as draws.
+  bool heuristic_rollout = true;
+  HeuristicStrategy rollout_strategy = HeuristicStrategy::kBigMoney;
+  int max_rollout_moves = 2000;
+  // Optional leaf evaluator (e.g. a value network): writes each player's
+  // expected return for a non-terminal leaf into `values`. Called
+  // concurrently when num_threads > 1.
+  std::function<void(const DominionState &leaf, std::array<double, kNumPlayers> *values)>
+      evaluator;
+  uint64_t seed = 0;
+};
+
+struct MctsStats {
+  int simulations = 0;
+  int nodes = 0;        // arena nodes in use after the search
+  int reused_nodes = 0; // nodes carried over from the previous search
+  int64_t edges = 0;    // edge arena entries in use, relocated blocks included
+  int max_depth = 0;
+  int threads = 0;
+};
+
+class MctsSearch {
+public:
+  struct Node {
+    // Edge block: first index into the edge arena (low 32 bits) and the
+    // number of children (high 32 bits), published together.
+    std::atomic<uint64_t> children{0};
+    std::atomic<int32_t> visits{0};
+    std::atomic<int32_t> in_flight{0}; // simulations currently through this edge
+    std::atomic<double> value{0.0};    // sum of `player`'s returns through this edge
+    int16_t action = -1; // edge from the parent (player actions fit 16 bits)
+    int8_t player = -1;  // player who chose `action`; -1 at the root
+    std::atomic<bool> expanding{false}; // held while the edge block grows
+  };
+  static_assert(kNumPlayerActions <= INT16_MAX, "action ids must fit Node::action");
+
+  explicit MctsSearch(const MctsConfig &config);
+  ~MctsSearch();
+  MctsSearch(const MctsSearch &) = delete;
+  MctsSearch &operator=(const MctsSearch &) = delete;
+
+  // Runs config.simulations simulations from `state` (a decision node) and
+  // returns the most visited legal root action.
+  Action Search(const DominionState &state);
+  // Drops the tree; the next Search() starts from scratch.
+  void Reset();
+
+  // Visit counts of the root's children by action id, e.g. as a policy
+  // target. Actions without a child are 0.
+  void RootVisitCounts(std::array<int, kNumPlayerActions> *counts) const;
+  const MctsStats &Stats() const { return stats_; }
+  // Tree inspection between searches; node 0 is the root.
+  int NumNodes() const;
+  const Node &GetNode(int index) const { return nodes_[index]; }
+  int NumChildren(int node) const;
+  int Child(int node, int k) const;
+
+private:
+  struct Worker;
+
+  // Index of the node for `state` when the current tree can be kept, else -1.
+  int FindReusableRoot(const DominionState &state) const;
+  void CompactFrom(int root);
+  // Takes n consecutive slots of an arena; -1 when it is full.
+  int AllocateNodes(int n);
+  int64_t AllocateEdges(int64_t n);
+  void Simulate(Worker *w, const DominionState &root);
+  // Adds children for the actions in `legal` the node lacks, unless the
+  // arenas are full or another thread is growing the node.
+  void Expand(int node, const std::vector<Action> &legal, Player player);
+  int SelectChild(const Worker &w, int node, Player player) const;
+  void Evaluate(Worker *w, DominionState *state, std::array<double, kNumPlayers> *values);
+
+  MctsConfig config_;
+  int64_t edge_capacity_;
+  std::unique_ptr<Node[]> nodes_;
+  std::unique_ptr<int32_t[]> edges_;
+  std::atomic<int> num_nodes_{0};
+  std::atomic<int64_t> num_edges_{0};
+  // Compaction targets, swapped with nodes_/edges_; allocated on first use.
+  std::unique_ptr<Node[]> spare_nodes_;
+  std::unique_ptr<int32_t[]> spare_edges_;
+  std::vector<int> queue_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic<int> next_simulation_{0};
+  std::vector<State::PlayerAction> root_history_;
+  MctsStats stats_;
+};
+
+// Bot that runs one MctsSearch per move (reusing the tree between its own
+// moves when config.reuse_tree).
+std::unique_ptr<Bot> MakeMctsBot(const MctsConfig &config);
+
+} // namespace dominion
+} // namespace open_spiel
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef OPEN_SPIEL_GAMES_DOMINION_REPLAY_H_
+#define OPEN_SPIEL_GAMES_DOMINION_REPLAY_H_
+
+#include <memory>
+#include <vector>
+
+#include "dominion.hpp"
+#include "open_spiel/spiel.h"
+
+namespace open_spiel {
+namespace dominion {
+
+// Random access into a recorded game. Snapshots the state every `interval`
+// moves so StateAt(k) clones the nearest earlier keyframe and replays at most
+// interval - 1 actions. The history and forced moves (History() and
+// ForcedMoves() of the played game) must come from a game whose initial state
+// is reproducible (e.g. opening_chance with seeded shuffles).
+class KeyframedReplay {
+public:
+  KeyframedReplay(std::shared_ptr<const Game> game, std::vector<Action> history,
+                  std::vector<ForcedMove> forced, int interval = 32);
+
+  int NumMoves() const { return static_cast<int>(history_.size()); }
+  int Interval() const { return interval_; }
+  // State after the first k recorded actions, 0 <= k <= NumMoves().
+  std::unique_ptr<State> StateAt(int k) const;
+
+private:
+  std::shared_ptr<const Game> game_;
+  std::vector<Action> history_;
+  std::vector<ForcedMove> forced_;
+  int interval_;
+  // keyframes_[i] is the state after i * interval_ actions.
+  std::vector<std::unique_ptr<State>> keyframes_;
+};
+
+} // namespace dominion
+} // namespace open_spiel
+
+#endif
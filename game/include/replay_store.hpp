@@ -0,0 +1,102 @@
+#ifndef OPEN_SPIEL_GAMES_DOMINION_REPLAY_STORE_H_
+#define OPEN_SPIEL_GAMES_DOMINION_REPLAY_STORE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "actions.hpp"
+#include "dominion.hpp"
+#include "open_spiel/spiel.h"
+
+namespace open_spiel {
+namespace dominion {
+
+inline constexpr int kLegalMaskBytes = (kNumPlayerActions + 7) / 8;
+// Largest SerializeBinary() output a record can hold.
+inline constexpr int kMaxStoredStateBytes = 512;
+
+// One training position, fixed-size so record i lives at a computed offset.
+// The state is stored from the perspective of `player`, the player to move.
+struct StoredPosition {
+  uint32_t ready; // set last, with release ordering, once the record is written
+  uint8_t player;
+  uint8_t reserved;
+  uint16_t state_size;
+  float outcome;  // final return for `player`
+  float priority; // weight for SamplePrioritized
+  uint8_t observation[kObservationBytes];
+  uint8_t legal_mask[kLegalMaskBytes];  // bit a set if action a is legal
+  uint16_t policy[kNumPlayerActions];   // target probability * 65535
+  uint8_t state[kMaxStoredStateBytes];  // DominionState::SerializeBinary()
+
+  bool IsLegal(Action a) const { return legal_mask[a >> 3] >> (a & 7) & 1; }
+  float Policy(Action a) const { return policy[a] / 65535.0f; }
+};
+
+// Fixed-capacity, memory-mapped position store shared between processes.
+// Workers Open() the same file and Append() concurrently: slots are reserved
+// with an atomic counter in the mapped header and published by their ready
+// flag, so readers only ever see complete records. Samplers read records in
+// place; nothing is replayed or parsed except by StateAt(). Priorities are
+// mirrored into a sum tree after the records, so Append, SetPriority and
+// each prioritized draw cost O(log capacity) whichever process made them.
+class ReplayStore {
+public:
+  // Creates (or truncates) a store with room for `capacity` positions.
+  static std::unique_ptr<ReplayStore> Create(const std::string &path,
+                                             uint64_t capacity);
+  // Maps an existing store for reading and appending.
+  static std::unique_ptr<ReplayStore> Open(const std::string &path);
+  ~ReplayStore();
+  ReplayStore(const ReplayStore &) = delete;
+  ReplayStore &operator=(const ReplayStore &) = delete;
+
+  // Records the position for the player to move in `state` (a decision node)
+  // with its search policy and eventual outcome. Returns false when full.
+  bool Append(const DominionState &state, const ActionsAndProbs &policy,
+              float outcome, float priority = 1.0f);
+
+  uint64_t Capacity() const;
+  // Reserved slots; a slot may still be in flight (see Ready).
+  uint64_t Size() const;
+  bool Ready(uint64_t i) const;
+  const StoredPosition &At(uint64_t i) const;
+  void SetPriority(uint64_t i, float priority);
+
+  // Samples `batch` ready positions uniformly, with replacement. Draws that
+  // hit in-flight slots are retried a bounded number of times, so `out` can
+  // come back short (or empty) while writers are still filling the store.
+  void SampleUniform(int batch, std::mt19937_64 &rng,
+                     std::vector<const StoredPosition *> *out) const;
+  // Samples proportionally to priority; positions with priority <= 0 are
+  // never drawn. Like SampleUniform, may return fewer than `batch`.
+  void SamplePrioritized(int batch, std::mt19937_64 &rng,
+                         std::vector<const StoredPosition *> *out) const;
+
+  std::unique_ptr<State> StateAt(const DominionGame &game, uint64_t i) const;
+
+private:
+  struct Header;
+  ReplayStore(int fd, void *base, size_t mapped_bytes);
+  StoredPosition &Slot(uint64_t i) const;
+  // Sets record i's leaf in the sum tree and adds the change to its parents.
+  void SetTreePriority(uint64_t i, float priority);
+
+  int fd_;
+  void *base_;
+  size_t mapped_bytes_;
+  Header *header_;
+  // Sum tree in the mapping: node 1 is the root, node k has children 2k and
+  // 2k + 1, and record i is leaf tree_leaves_ + i.
+  double *tree_;
+  uint64_t tree_leaves_;
+};
+
+} // namespace dominion
+} // namespace open_spiel
+
+#endif
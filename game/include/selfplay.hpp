@@ -0,0 +1,91 @@
+#ifndef OPEN_SPIEL_GAMES_DOMINION_SELFPLAY_H_
+#define OPEN_SPIEL_GAMES_DOMINION_SELFPLAY_H_
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "dominion.hpp"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_bots.h"
+
+namespace open_spiel {
+namespace dominion {
+
+// Multi-threaded self-play.
+//
+// RunSelfPlay plays `num_games` independent games on a pool of worker
+// threads. Game indices are dealt out in contiguous runs, one deque per
+// worker; a worker takes from the back of its own deque and, once it is
+// empty, steals from the front of another's, so long games on one thread do
+// not leave the others idle.
+//
+// Each game draws every random number (chance outcomes and bot seeds) from
+// its own stream seeded by the run seed and the game index, so a game's
+// moves do not depend on the thread that ran it or on scheduling. With the
+// "opening_chance" game parameter the opening deal is a chance node too and
+// the whole game is a function of its seed.
+
+// Samples one of state.ChanceOutcomes() using a splitmix64 stream.
+Action SampleChanceOutcome(const State &state, uint64_t &stream);
+
+// Creates the bot for `player` in one game. Called on the worker thread that
+// plays the game, so bots need not be thread-safe.
+using BotFactory = std::function<std::unique_ptr<Bot>(Player player, uint64_t seed)>;
+
+// Built-in seat policies by name:
+//   "random":   uniform over the legal actions.
+//   "bigmoney", "bm_smithy", "bm_militia", "bm_witch", "chapel": the
+//               heuristic strategies of heuristic_bots.hpp.
+//   "mcts":     MctsSearch (mcts.hpp) with 200 simulations per move and
+//               Big Money rollouts.
+// Fatal error for any other name.
+BotFactory MakeBotFactory(const std::string &name);
+
+struct SelfPlayConfig {
+  int num_games = 1000;
+  int num_threads = 0; // 0: std::thread::hardware_concurrency()
+  uint64_t seed = 0;
+  // Games still running after this many moves are stopped and reported as
+  // capped, with zero returns.
+  int max_moves = 5000;
+  // Keep every applied action (chance outcomes included) in SelfPlayGame.
+  bool record_actions = true;
+};
+
+struct SelfPlayGame {
+  int index = 0;
+  uint64_t seed = 0;
+  int worker = 0;
+  std::unique_ptr<State> initial; // state before the first move
+  std::vector<Action> actions;    // empty unless record_actions
+  std::vector<double> returns;
+  int moves = 0;
+  bool capped = false;
+};
+
+// Receives every finished game, in completion order. Calls are serialized
+// across workers, so a sink may write to a shared stream without locking.
+using GameSink = std::function<void(const SelfPlayGame &)>;
+
+struct SelfPlayStats {
+  int games = 0;
+  int capped = 0;
+  int64_t moves = 0;
+  int64_t steals = 0; // games run by a thread other than the one dealt them
+  int threads = 0;
+  double seconds = 0;
+  std::array<double, kNumPlayers> total_returns{};
+};
+
+// `seats` holds one factory per player. `sink` may be empty.
+SelfPlayStats RunSelfPlay(const DominionGame &game, const SelfPlayConfig &config,
+                          const std::vector<BotFactory> &seats, const GameSink &sink);
+
+} // namespace dominion
+} // namespace open_spiel
+
+#endif
@@ -0,0 +1,220 @@
+#ifndef OPEN_SPIEL_GAMES_DOMINION_SERIALIZATION_H_
+#define OPEN_SPIEL_GAMES_DOMINION_SERIALIZATION_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "dominion.hpp"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace dominion {
+
+// Compact binary state format (DominionState::SerializeBinary):
+//   header   "DB", version byte, mode flags byte (explicit/counts/opening)
+//   state    turn scalars as varints, initial supply plus cards taken from
+//            it, play area, then per player: deck, count arrays, deck_rng
+//            (8 little-endian bytes, omitted when zero), pending choice,
+//            effect queue records and the public card tracker.
+// Card lists (deck, play area) are a length and six bits per card.
+// Count arrays start with the number of non-zero entries. Sparse form: one
+// byte per entry holding the index in its low six bits and the count in the
+// top two, where a zero count field means the count follows as a varint.
+// Dense form (high bit of the first byte set, chosen when shorter): a bitmap
+// of non-zero indices, then each count as a varint. Bump kBinaryStateVersion
+// whenever the layout changes.
+inline constexpr char kBinaryStateMagic[2] = {'D', 'B'};
+inline constexpr uint8_t kBinaryStateVersion = 2;
+inline constexpr int kCountsBitmapBytes = (kNumSupplyPiles + 7) / 8;
+
+// Appends primitive values to a byte string.
+class ByteWriter {
+public:
+  explicit ByteWriter(std::string *out) : out_(out) {}
+
+  void U8(uint8_t v) { out_->push_back(static_cast<char>(v)); }
+  // LEB128: seven bits per byte, high bit set on all but the last byte.
+  void Varint(uint64_t v) {
+    while (v >= 0x80) {
+      U8(static_cast<uint8_t>(v | 0x80));
+      v >>= 7;
+    }
+    U8(static_cast<uint8_t>(v));
+  }
+  // Zigzag-encoded so small negative values (e.g. -1 sentinels) stay short.
+  void SignedVarint(int64_t v) {
+    Varint((static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63));
+  }
+  void Fixed64(uint64_t v) {
+    for (int i = 0; i < 8; ++i) U8(static_cast<uint8_t>(v >> (8 * i)));
+  }
+  void Float(float f) {
+    uint32_t v;
+    std::memcpy(&v, &f, sizeof(v));
+    for (int i = 0; i < 4; ++i) U8(static_cast<uint8_t>(v >> (8 * i)));
+  }
+  void Bytes(const std::string &bytes) {
+    Varint(bytes.size());
+    out_->append(bytes);
+  }
+  void Counts(const std::array<int, kNumSupplyPiles> &counts) {
+    int nonzero = 0, sparse_size = 0, dense_size = kCountsBitmapBytes;
+    for (int c : counts) {
+      if (c == 0) continue;
+      nonzero += 1;
+      sparse_size += 1 + (InlineCount(c) ? 0 : SignedVarintSize(c));
+      dense_size += SignedVarintSize(c);
+    }
+    if (dense_size < sparse_size) {
+      U8(static_cast<uint8_t>(nonzero | 0x80));
+      uint64_t bits = 0;
+      for (int j = 0; j < kNumSupplyPiles; ++j) {
+        if (counts[j] != 0) bits |= uint64_t{1} << j;
+      }
+      for (int i = 0; i < kCountsBitmapBytes; ++i) U8(static_cast<uint8_t>(bits >> (8 * i)));
+      for (int c : counts) {
+        if (c != 0) SignedVarint(c);
+      }
+      return;
+    }
+    U8(static_cast<uint8_t>(nonzero));
+    for (int j = 0; j < kNumSupplyPiles; ++j) {
+      int c = counts[j];
+      if (c == 0) continue;
+      U8(static_cast<uint8_t>(j | (InlineCount(c) ? c << 6 : 0)));
+      if (!InlineCount(c)) SignedVarint(c);
+    }
+  }
+
+  // Ordered card list: length, then six bits per card, packed little-endian.
+  void Cards(const std::vector<CardName> &cards) {
+    Varint(cards.size());
+    uint32_t acc = 0;
+    int bits = 0;
+    for (CardName cn : cards) {
+      acc |= static_cast<uint32_t>(cn) << bits;
+      bits += 6;
+      while (bits >= 8) {
+        U8(static_cast<uint8_t>(acc));
+        acc >>= 8;
+        bits -= 8;
+      }
+    }
+    if (bits > 0) U8(static_cast<uint8_t>(acc));
+  }
+
+private:
+  static bool InlineCount(int c) { return c > 0 && c < 4; }
+  static int SignedVarintSize(int64_t v) {
+    uint64_t z = (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+    int n = 1;
+    while (z >= 0x80) {
+      z >>= 7;
+      ++n;
+    }
+    return n;
+  }
+
+  std::string *out_;
+};
+
+// Reads values written by ByteWriter. Truncated or malformed input is a fatal
+// error, as with malformed JSON.
+class ByteReader {
+public:
+  ByteReader(const char *data, size_t size) : data_(data), size_(size) {}
+
+  bool AtEnd() const { return pos_ == size_; }
+  size_t Position() const { return pos_; }
+
+  uint8_t U8() {
+    SPIEL_CHECK_LT(pos_, size_);
+    return static_cast<uint8_t>(data_[pos_++]);
+  }
+  uint64_t Varint() {
+    uint64_t v = 0;
+    for (int shift = 0;; shift += 7) {
+      SPIEL_CHECK_LT(shift, 64);
+      uint8_t b = U8();
+      v |= static_cast<uint64_t>(b & 0x7F) << shift;
+      if (!(b & 0x80)) return v;
+    }
+  }
+  int64_t SignedVarint() {
+    uint64_t z = Varint();
+    return static_cast<int64_t>(z >> 1) ^ -static_cast<int64_t>(z & 1);
+  }
+  uint64_t Fixed64() {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; ++i) v |= static_cast<uint64_t>(U8()) << (8 * i);
+    return v;
+  }
+  float Float() {
+    uint32_t v = 0;
+    for (int i = 0; i < 4; ++i) v |= static_cast<uint32_t>(U8()) << (8 * i);
+    float f;
+    std::memcpy(&f, &v, sizeof(f));
+    return f;
+  }
+  std::string Bytes() {
+    size_t n = Varint();
+    SPIEL_CHECK_LE(n, size_ - pos_);
+    std::string out(data_ + pos_, n);
+    pos_ += n;
+    return out;
+  }
+  void Counts(std::array<int, kNumSupplyPiles> *counts) {
+    counts->fill(0);
+    uint8_t head = U8();
+    if (head & 0x80) {
+      uint64_t bits = 0;
+      for (int i = 0; i < kCountsBitmapBytes; ++i) bits |= static_cast<uint64_t>(U8()) << (8 * i);
+      SPIEL_CHECK_EQ(bits >> kNumSupplyPiles, uint64_t{0});
+      for (int j = 0; j < kNumSupplyPiles; ++j) {
+        if (bits >> j & 1) (*counts)[j] = static_cast<int>(SignedVarint());
+      }
+      return;
+    }
+    int nonzero = head;
+    for (int k = 0; k < nonzero; ++k) {
+      uint8_t b = U8();
+      int j = b & 0x3F;
+      SPIEL_CHECK_TRUE(IsValidPileIndex(j));
+      (*counts)[j] = (b >> 6) ? (b >> 6) : static_cast<int>(SignedVarint());
+    }
+  }
+
+  void Cards(std::vector<CardName> *cards) {
+    size_t n = Varint();
+    SPIEL_CHECK_LE(n * 3, (size_ - pos_) * 4);
+    cards->clear();
+    cards->reserve(n);
+    uint32_t acc = 0;
+    int bits = 0;
+    for (size_t i = 0; i < n; ++i) {
+      if (bits < 6) {
+        acc |= static_cast<uint32_t>(U8()) << bits;
+        bits += 8;
+      }
+      int j = static_cast<int>(acc & 0x3F);
+      SPIEL_CHECK_TRUE(IsValidPileIndex(j));
+      cards->push_back(static_cast<CardName>(j));
+      acc >>= 6;
+      bits -= 6;
+    }
+  }
+
+private:
+  const char *data_;
+  size_t size_;
+  size_t pos_ = 0;
+};
+
+} // namespace dominion
+} // namespace open_spiel
+
+#endif
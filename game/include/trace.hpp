@@ -0,0 +1,102 @@
+#ifndef OPEN_SPIEL_GAMES_DOMINION_TRACE_H_
+#define OPEN_SPIEL_GAMES_DOMINION_TRACE_H_
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace open_spiel {
+namespace dominion {
+namespace trace {
+
+// Sampled span tracing exported as Chrome trace-event JSON (load it in
+// chrome://tracing or Perfetto).
+//
+// Tracing is off until Enable(). Spans are recorded only on a thread whose
+// current game was sampled: a GameSpan samples one game in every
+// `sample_every` per thread, and SetThreadSampled() covers code that runs
+// outside games. An unsampled span costs one thread-local flag test.
+//
+// Each thread records into its own fixed-size ring (oldest events are
+// overwritten) guarded by an uncontended per-thread lock; WriteChromeTrace()
+// copies every ring, so it may run while workers are still recording.
+// Span names must be string literals (only the pointer is stored).
+
+struct TraceOptions {
+  int ring_capacity = 1 << 16; // events kept per thread
+  int sample_every = 1;        // record every n-th game per thread
+};
+
+void Enable(const TraceOptions &options = TraceOptions());
+void Disable();
+bool Enabled();
+// Drops all recorded events.
+void Clear();
+// Writes the recorded events of every thread; false if the file can't be
+// written.
+bool WriteChromeTrace(const std::string &path);
+
+namespace internal {
+extern thread_local bool t_sampled;
+inline uint64_t NowNs() {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::steady_clock::now().time_since_epoch())
+                                   .count());
+}
+void Record(const char *name, uint64_t start_ns, uint64_t end_ns, int64_t arg);
+bool BeginGame();
+} // namespace internal
+
+// Whether spans on this thread are currently recorded.
+inline bool Sampled() { return internal::t_sampled; }
+// Records this thread's spans outside any GameSpan (e.g. a benchmark loop).
+void SetThreadSampled(bool sampled);
+
+// Scoped complete event ("X" phase). `arg` is shown as args.value if >= 0.
+class Span {
+public:
+  explicit Span(const char *name, int64_t arg = -1)
+      : name_(internal::t_sampled ? name : nullptr), arg_(arg),
+        start_(name_ ? internal::NowNs() : 0) {}
+  ~Span() {
+    if (name_) internal::Record(name_, start_, internal::NowNs(), arg_);
+  }
+  Span(const Span &) = delete;
+  Span &operator=(const Span &) = delete;
+
+private:
+  const char *name_;
+  int64_t arg_;
+  uint64_t start_;
+};
+
+// Marks one game on this thread and decides whether it is sampled. Turn
+// boundaries reported by the engine become "turn" spans within it.
+class GameSpan {
+public:
+  GameSpan();
+  ~GameSpan();
+  GameSpan(const GameSpan &) = delete;
+  GameSpan &operator=(const GameSpan &) = delete;
+
+private:
+  bool outer_sampled_;
+  bool sampled_;
+  uint64_t start_;
+};
+
+// Called by the engine when a turn ends; closes the current "turn" span of
+// a sampled game on this thread.
+void TurnBoundary(int turn_number);
+
+} // namespace trace
+} // namespace dominion
+} // namespace open_spiel
+
+#define DOMINION_TRACE_CONCAT_(a, b) a##b
+#define DOMINION_TRACE_CONCAT(a, b) DOMINION_TRACE_CONCAT_(a, b)
+#define DOMINION_TRACE_SPAN(...)                                                \
+  ::open_spiel::dominion::trace::Span DOMINION_TRACE_CONCAT(dominion_trace_,    \
+                                                            __LINE__)(__VA_ARGS__)
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef OPEN_SPIEL_GAMES_DOMINION_TRAJECTORY_H_
+#define OPEN_SPIEL_GAMES_DOMINION_TRAJECTORY_H_
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "dominion.hpp"
+#include "open_spiel/spiel.h"
+
+namespace open_spiel {
+namespace dominion {
+
+// Append-only self-play trajectory files.
+//
+// A game is stored as its initial state (SerializeBinary) followed by one
+// record per recorded move: the action id (decisions and chance outcomes
+// alike), plus an optional sparse policy target and value target. Shuffles
+// are seeded by their chance outcome and forced moves are re-derived, so the
+// actions alone rebuild every later state; no per-move counts are stored.
+//
+// File layout: "DT", version byte, then blocks. A block is a codec byte
+// (raw or deflate), the raw and stored sizes as varints, and the payload: a
+// run of length-prefixed game records. Deflate is used when the library is
+// built with zlib (DOMINION_HAVE_ZLIB); readers without it reject such blocks.
+inline constexpr char kTrajectoryMagic[2] = {'D', 'T'};
+inline constexpr uint8_t kTrajectoryVersion = 1;
+// Games are buffered until a block holds at least this many raw bytes.
+inline constexpr size_t kTrajectoryBlockBytes = 1 << 16;
+
+struct TrajectoryStep {
+  Action action = kInvalidAction;
+  // Search policy over the legal actions at this move; empty if not recorded.
+  ActionsAndProbs policy;
+  bool has_value = false;
+  float value = 0;
+};
+
+struct Trajectory {
+  std::string initial_state; // DominionState::SerializeBinary()
+  std::vector<TrajectoryStep> steps;
+  std::vector<double> returns;
+
+  // State after the first k steps; k == steps.size() gives the final state.
+  std::unique_ptr<State> StateAt(const DominionGame &game, int k) const;
+};
+
+class TrajectoryWriter {
+public:
+  // Appends to `path`, writing the file header if the file is new or empty.
+  explicit TrajectoryWriter(const std::string &path);
+  ~TrajectoryWriter();
+
+  void BeginGame(const DominionState &initial);
+  void AddStep(Action action, const ActionsAndProbs *policy = nullptr,
+               const float *value = nullptr);
+  void EndGame(const std::vector<double> &returns);
+  // Writes any buffered games as a block.
+  void Flush();
+
+private:
+  std::ofstream out_;
+  std::string block_;        // finished games not yet written
+  std::string game_;         // steps of the game in progress
+  std::string initial_;      // initial state of the game in progress
+  int num_steps_ = 0;
+  bool in_game_ = false;
+};
+
+class TrajectoryReader {
+public:
+  explicit TrajectoryReader(const std::string &path);
+
+  // Reads the next game; returns false at end of file.
+  bool Next(Trajectory *trajectory);
+
+private:
+  bool ReadBlock();
+
+  std::ifstream in_;
+  std::string block_;
+  size_t block_pos_ = 0;
+};
+
+} // namespace dominion
+} // namespace open_spiel
+
+#endif
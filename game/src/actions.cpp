@@ -35,7 +35,9 @@ std::string ActionNames::Name(Action action_id, int num_supply_piles) {
     return std::string("GainSelect_") + std::to_string(j);
   }
 
-  if (action_id == Shuffle()) return "Shuffle";
+  if (action_id >= Shuffle() && action_id < ShuffleSeed(kNumShuffleSeeds)) {
+    return std::string("Shuffle_") + std::to_string(action_id - Shuffle());
+  }
 
   return std::string("Unknown_") + std::to_string(action_id);
 }
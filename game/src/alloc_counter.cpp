@@ -0,0 +1,66 @@
+#include "alloc_counter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::atomic<uint64_t> g_allocations{0};
+// Trivially initialized, so usable from operator new at any point.
+thread_local uint64_t t_allocations = 0;
+
+void Note() {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  t_allocations += 1;
+}
+
+void *CountedAlloc(std::size_t size) {
+  Note();
+  if (void *p = std::malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+
+void *CountedAlignedAlloc(std::size_t size, std::align_val_t align) {
+  Note();
+  std::size_t a = static_cast<std::size_t>(align);
+  std::size_t rounded = (size + a - 1) / a * a;
+  if (void *p = std::aligned_alloc(a, rounded ? rounded : a)) return p;
+  throw std::bad_alloc();
+}
+
+void *CountedAllocNoThrow(std::size_t size) noexcept {
+  Note();
+  return std::malloc(size ? size : 1);
+}
+} // namespace
+
+void *operator new(std::size_t size) { return CountedAlloc(size); }
+void *operator new[](std::size_t size) { return CountedAlloc(size); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept { return CountedAllocNoThrow(size); }
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept { return CountedAllocNoThrow(size); }
+void *operator new(std::size_t size, std::align_val_t a) { return CountedAlignedAlloc(size, a); }
+void *operator new[](std::size_t size, std::align_val_t a) { return CountedAlignedAlloc(size, a); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace open_spiel {
+namespace dominion {
+namespace alloc {
+
+uint64_t ProcessAllocations() {
+  return g_allocations.load(std::memory_order_relaxed);
+}
+
+uint64_t ThreadAllocations() { return t_allocations; }
+
+} // namespace alloc
+} // namespace dominion
+} // namespace open_spiel
@@ -0,0 +1,103 @@
+#include "batch_env.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "open_spiel/spiel_utils.h"
+#include "selfplay.hpp"
+
+namespace open_spiel {
+namespace dominion {
+
+BatchEnv::BatchEnv(std::shared_ptr<const Game> game, int batch_size, uint64_t seed,
+                   int max_moves)
+    : game_(std::move(game)), batch_size_(batch_size), max_moves_(max_moves) {
+  SPIEL_CHECK_TRUE(dynamic_cast<const DominionGame *>(game_.get()) != nullptr);
+  SPIEL_CHECK_GT(batch_size_, 0);
+  SPIEL_CHECK_GT(max_moves_, 0);
+  states_.resize(batch_size_);
+  rng_.resize(batch_size_);
+  for (int i = 0; i < batch_size_; ++i) {
+    uint64_t mix = seed + 0x9E3779B97F4A7C15ULL * static_cast<uint64_t>(i + 1);
+    rng_[i] = SplitMix64(mix);
+  }
+  moves_.assign(batch_size_, 0);
+  current_player_.assign(batch_size_, 0);
+  rewards_.assign(static_cast<size_t>(batch_size_) * kNumPlayers, 0.0f);
+  terminal_.assign(batch_size_, 0);
+  truncated_.assign(batch_size_, 0);
+  observations_.assign(static_cast<size_t>(batch_size_) * kObservationBytes, 0);
+  legal_mask_.assign(static_cast<size_t>(batch_size_) * kLegalMaskStride, 0);
+  Reset();
+}
+
+void BatchEnv::Reset() {
+  std::fill(rewards_.begin(), rewards_.end(), 0.0f);
+  std::fill(terminal_.begin(), terminal_.end(), 0);
+  std::fill(truncated_.begin(), truncated_.end(), 0);
+  for (int i = 0; i < batch_size_; ++i) {
+    ResetSlot(i);
+    WriteOutputs(i);
+  }
+}
+
+void BatchEnv::ResetSlot(int i) {
+  states_[i] = game_->NewInitialState();
+  moves_[i] = 0;
+  ResolveChance(i);
+}
+
+void BatchEnv::ResolveChance(int i) {
+  State &s = *states_[i];
+  while (s.IsChanceNode()) s.ApplyAction(SampleChanceOutcome(s, rng_[i]));
+}
+
+void BatchEnv::WriteOutputs(int i) {
+  const auto &s = static_cast<const DominionState &>(*states_[i]);
+  Player player = s.CurrentPlayer();
+  current_player_[i] = player;
+  s.ObservationBytes(player, &observations_[static_cast<size_t>(i) * kObservationBytes]);
+  uint8_t *mask = &legal_mask_[static_cast<size_t>(i) * kLegalMaskStride];
+  std::memset(mask, 0, kLegalMaskStride);
+  for (Action a : s.LegalActions()) mask[a] = 1;
+}
+
+void BatchEnv::Step(const std::vector<Action> &actions) {
+  SPIEL_CHECK_EQ(static_cast<int>(actions.size()), batch_size_);
+  Step(actions.data());
+}
+
+void BatchEnv::Step(const Action *actions) {
+  for (int i = 0; i < batch_size_; ++i) {
+    Action a = actions[i];
+    float *reward = &rewards_[static_cast<size_t>(i) * kNumPlayers];
+    std::fill(reward, reward + kNumPlayers, 0.0f);
+    terminal_[i] = 0;
+    truncated_[i] = 0;
+    if (a < 0 || a >= kLegalMaskStride ||
+        !legal_mask_[static_cast<size_t>(i) * kLegalMaskStride + a]) {
+      SpielFatalError("BatchEnv: illegal action " + std::to_string(a) + " in game " +
+                      std::to_string(i));
+    }
+    State &s = *states_[i];
+    s.ApplyAction(a);
+    moves_[i] += 1;
+    ResolveChance(i);
+    if (s.IsTerminal()) {
+      std::vector<double> returns = s.Returns();
+      for (int p = 0; p < kNumPlayers; ++p) reward[p] = static_cast<float>(returns[p]);
+      terminal_[i] = 1;
+    } else if (moves_[i] >= max_moves_) {
+      truncated_[i] = 1;
+    }
+    if (terminal_[i] || truncated_[i]) {
+      episodes_ += 1;
+      ResetSlot(i);
+    }
+    WriteOutputs(i);
+  }
+}
+
+} // namespace dominion
+} // namespace open_spiel
@@ -0,0 +1,157 @@
+#include "bench.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include "alloc_counter.hpp"
+#include "trace.hpp"
+#include "open_spiel/json/include/nlohmann/json.hpp"
+
+namespace open_spiel {
+namespace dominion {
+namespace bench {
+
+BenchState::BenchState(int64_t iterations)
+    : iterations_(iterations), start_(Clock::now()),
+      alloc_start_(alloc::ProcessAllocations()) {}
+
+void BenchState::PauseTiming() {
+  if (!running_) return;
+  elapsed_ns_ += std::chrono::duration<double, std::nano>(Clock::now() - start_).count();
+  allocs_ += alloc::ProcessAllocations() - alloc_start_;
+  running_ = false;
+}
+
+void BenchState::ResumeTiming() {
+  if (running_) return;
+  running_ = true;
+  alloc_start_ = alloc::ProcessAllocations();
+  start_ = Clock::now();
+}
+
+struct BenchEntry {
+  std::string name;
+  BenchFn fn;
+};
+
+static std::vector<BenchEntry> &Registry() {
+  static std::vector<BenchEntry> registry;
+  return registry;
+}
+
+void RegisterBench(const std::string &name, BenchFn fn) {
+  Registry().push_back({name, std::move(fn)});
+}
+
+namespace {
+BenchState RunOnce(const BenchFn &fn, int64_t iterations) {
+  BenchState st(iterations);
+  fn(st);
+  st.PauseTiming();
+  return st;
+}
+} // namespace
+
+int RunBenchmarks(int argc, char **argv) {
+  std::string filter, json_path, trace_path;
+  double min_time = 0.2;
+  trace::TraceOptions trace_options;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg.rfind("--filter=", 0) == 0) {
+      filter = arg.substr(9);
+    } else if (arg.rfind("--min_time=", 0) == 0) {
+      min_time = std::atof(arg.c_str() + 11);
+    } else if (arg.rfind("--json=", 0) == 0) {
+      json_path = arg.substr(7);
+    } else if (arg.rfind("--trace=", 0) == 0) {
+      trace_path = arg.substr(8);
+    } else if (arg.rfind("--trace_every=", 0) == 0) {
+      trace_options.sample_every = std::atoi(arg.c_str() + 14);
+    } else {
+      std::cerr << "usage: " << argv[0]
+                << " [--filter=substr] [--min_time=seconds] [--json=path]"
+                   " [--trace=path] [--trace_every=n]\n";
+      return 2;
+    }
+  }
+
+  if (!trace_path.empty()) trace::Enable(trace_options);
+
+  nlohmann::json results = nlohmann::json::array();
+  std::printf("%-44s %12s %14s %12s\n", "benchmark", "iterations", "ns/op", "allocs/op");
+  for (const auto &entry : Registry()) {
+    if (!filter.empty() && entry.name.find(filter) == std::string::npos) continue;
+    // Warm-up run: lazily built fixtures and cold caches stay out of timing.
+    RunOnce(entry.fn, 1);
+    int64_t iterations = 1;
+    BenchState st = RunOnce(entry.fn, iterations);
+    // Bodies with nothing to measure report zero items and are not scaled up.
+    while (st.items() > 0 && st.elapsed_ns() < min_time * 1e9 &&
+           iterations < (int64_t{1} << 30)) {
+      // Aim 20% past the target based on the last run, growing at most 10x.
+      double per_iter = st.elapsed_ns() / iterations;
+      int64_t next = per_iter > 0
+                         ? static_cast<int64_t>(min_time * 1.2e9 / per_iter)
+                         : iterations * 10;
+      iterations = std::max(iterations + 1, std::min(next, iterations * 10));
+      st = RunOnce(entry.fn, iterations);
+    }
+    int64_t items = st.items();
+    double ns_per_op = items > 0 ? st.elapsed_ns() / items : 0.0;
+    double allocs_per_op = items > 0 ? static_cast<double>(st.allocations()) / items : 0.0;
+    std::printf("%-44s %12lld %14.1f %12.2f", entry.name.c_str(),
+                static_cast<long long>(iterations), ns_per_op, allocs_per_op);
+    nlohmann::json r = {{"name", entry.name},
+                        {"iterations", iterations},
+                        {"items", items},
+                        {"real_time_ns", st.elapsed_ns()},
+                        {"ns_per_op", ns_per_op},
+                        {"allocs_per_op", allocs_per_op},
+                        // Per game for playout benchmarks.
+                        {"allocs_per_iteration",
+                         static_cast<double>(st.allocations()) / iterations}};
+    double seconds = st.elapsed_ns() / 1e9;
+    for (const auto &[name, value] : st.counters()) {
+      double rate = seconds > 0 ? value / seconds : 0.0;
+      r["counters"][name] = value;
+      r["counters"][name + "_per_sec"] = rate;
+      std::printf("  %s/s=%.0f", name.c_str(), rate);
+    }
+    std::printf("\n");
+    results.push_back(std::move(r));
+  }
+
+  if (!trace_path.empty() && !trace::WriteChromeTrace(trace_path)) {
+    std::cerr << "cannot write " << trace_path << "\n";
+    return 1;
+  }
+
+  if (!json_path.empty()) {
+    nlohmann::json doc;
+    doc["context"] = {{"timestamp", static_cast<int64_t>(std::time(nullptr))},
+                      {"min_time_s", min_time},
+#ifdef NDEBUG
+                      {"assertions", false},
+#else
+                      {"assertions", true},
+#endif
+                      {"filter", filter}};
+    doc["benchmarks"] = std::move(results);
+    std::ofstream out(json_path);
+    if (!out) {
+      std::cerr << "cannot write " << json_path << "\n";
+      return 1;
+    }
+    out << doc.dump(2) << "\n";
+  }
+  return 0;
+}
+
+} // namespace bench
+} // namespace dominion
+} // namespace open_spiel
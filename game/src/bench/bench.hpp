@@ -0,0 +1,67 @@
+#ifndef OPEN_SPIEL_GAMES_DOMINION_BENCH_H_
+#define OPEN_SPIEL_GAMES_DOMINION_BENCH_H_
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+
+namespace open_spiel {
+namespace dominion {
+namespace bench {
+
+// Handed to each benchmark body. The body performs iterations() operations,
+// optionally excluding setup with PauseTiming()/ResumeTiming(), and may
+// report counters; per-op and per-second rates are derived from them.
+class BenchState {
+public:
+  explicit BenchState(int64_t iterations);
+
+  int64_t iterations() const { return iterations_; }
+  // Operations the body actually performed, if not iterations() (e.g. moves
+  // of a playout benchmark).
+  void SetItemsProcessed(int64_t items) { items_ = items; }
+  void AddCounter(const std::string &name, double value) { counters_[name] += value; }
+  void PauseTiming();
+  void ResumeTiming();
+
+  // Results, valid once the body has returned and timing is paused.
+  int64_t items() const { return items_ >= 0 ? items_ : iterations_; }
+  double elapsed_ns() const { return elapsed_ns_; }
+  uint64_t allocations() const { return allocs_; }
+  const std::map<std::string, double> &counters() const { return counters_; }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  int64_t iterations_;
+  int64_t items_ = -1;
+  std::map<std::string, double> counters_;
+  bool running_ = true;
+  Clock::time_point start_;
+  double elapsed_ns_ = 0;
+  uint64_t alloc_start_ = 0;
+  uint64_t allocs_ = 0;
+};
+
+using BenchFn = std::function<void(BenchState &)>;
+
+void RegisterBench(const std::string &name, BenchFn fn);
+
+// Runs the registered benchmarks whose name contains --filter=..., each for
+// at least --min_time=<seconds> (default 0.2), printing a table and writing
+// JSON results to --json=<path> if given. --trace=<path> enables span tracing
+// of every --trace_every=<n>-th game (default 1) and writes a Chrome trace.
+// Returns a process exit code.
+int RunBenchmarks(int argc, char **argv);
+
+// Benchmark suites of the dominion_bench binary.
+void RegisterCoreBenchmarks(); // dominion_bench.cpp
+void RegisterCardBenchmarks(); // card_bench.cpp
+
+} // namespace bench
+} // namespace dominion
+} // namespace open_spiel
+
+#endif
@@ -0,0 +1,180 @@
+// Per-card effect benchmarks: each iteration resolves one card's effect in
+// full, from playing it to the last choice of its effect queue, on a clone of
+// a hand-built position.
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+
+#include "actions.hpp"
+#include "bench.hpp"
+#include "dominion.hpp"
+
+namespace open_spiel {
+namespace dominion {
+
+// Position-building helpers in the style of DominionTestHarness.
+struct DominionBenchHarness {
+  static void SetCards(DominionState *s, int player,
+                       const std::vector<CardName> &hand, CardName deck_card,
+                       int deck_size) {
+    PlayerState &ps = s->player_states_[player];
+    ps.deck_.assign(deck_size, deck_card);
+    ps.deck_counts_.fill(0);
+    ps.hand_counts_.fill(0);
+    ps.discard_counts_.fill(0);
+    ps.effect_queue.clear();
+    ps.pending_choice = PendingChoice::None;
+    ps.public_cards_ = PublicCardTracker{};
+    ps.public_cards_.owned[static_cast<int>(deck_card)] = deck_size;
+    for (CardName cn : hand) {
+      ps.hand_counts_[static_cast<int>(cn)] += 1;
+      ps.public_cards_.owned[static_cast<int>(cn)] += 1;
+    }
+  }
+  static void StartActionPhase(DominionState *s) {
+    s->current_player_ = 0;
+    s->phase_ = Phase::actionPhase;
+    s->actions_ = 1;
+    s->buys_ = 1;
+    s->coins_ = 0;
+    s->play_area_.clear();
+  }
+  static bool EffectsResolved(const DominionState &s) {
+    for (const PlayerState &ps : s.player_states_) {
+      if (!ps.effect_queue.empty() || ps.pending_choice != PendingChoice::None) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+namespace bench {
+namespace {
+
+using H = DominionBenchHarness;
+
+Action Play(CardName cn) { return ActionIds::PlayHandIndex(static_cast<int>(cn)); }
+Action Trash(CardName cn) { return ActionIds::TrashHandSelect(static_cast<int>(cn)); }
+Action Discard(CardName cn) { return ActionIds::DiscardHandSelect(static_cast<int>(cn)); }
+Action Gain(CardName cn) { return ActionIds::GainSelect(static_cast<int>(cn)); }
+
+// A position with player 0 to act and the actions resolving one card.
+// Multi-select effects take selections in ascending CardName order.
+struct CardScenario {
+  std::string name;
+  std::vector<CardName> hand;    // player 0
+  std::vector<CardName> opponent_hand;
+  std::vector<Action> script;
+};
+
+std::vector<CardScenario> Scenarios() {
+  using C = CardName;
+  return {
+      {"ThroneRoomChain",
+       {C::CARD_ThroneRoom, C::CARD_ThroneRoom, C::CARD_Smithy, C::CARD_Smithy},
+       {},
+       {Play(C::CARD_ThroneRoom), Play(C::CARD_ThroneRoom), Play(C::CARD_Smithy),
+        Play(C::CARD_Smithy)}},
+      {"Chapel",
+       {C::CARD_Chapel, C::CARD_Estate, C::CARD_Estate, C::CARD_Estate, C::CARD_Copper},
+       {},
+       {Play(C::CARD_Chapel), Trash(C::CARD_Copper), Trash(C::CARD_Estate),
+        Trash(C::CARD_Estate), Trash(C::CARD_Estate)}},
+      {"Cellar",
+       {C::CARD_Cellar, C::CARD_Estate, C::CARD_Estate, C::CARD_Estate, C::CARD_Copper},
+       {},
+       {Play(C::CARD_Cellar), Discard(C::CARD_Copper), Discard(C::CARD_Estate),
+        Discard(C::CARD_Estate), ActionIds::DiscardHandSelectFinish()}},
+      {"Militia",
+       {C::CARD_Militia, C::CARD_Copper, C::CARD_Copper, C::CARD_Copper, C::CARD_Copper},
+       {C::CARD_Copper, C::CARD_Copper, C::CARD_Copper, C::CARD_Estate, C::CARD_Estate},
+       {Play(C::CARD_Militia), Discard(C::CARD_Estate), Discard(C::CARD_Estate)}},
+      {"Witch",
+       {C::CARD_Witch, C::CARD_Copper, C::CARD_Copper, C::CARD_Copper, C::CARD_Copper},
+       {},
+       {Play(C::CARD_Witch)}},
+      {"Remodel",
+       {C::CARD_Remodel, C::CARD_Estate, C::CARD_Copper, C::CARD_Copper, C::CARD_Copper},
+       {},
+       {Play(C::CARD_Remodel), Trash(C::CARD_Estate), Gain(C::CARD_Silver)}},
+      {"Mine",
+       {C::CARD_Mine, C::CARD_Copper, C::CARD_Estate, C::CARD_Estate, C::CARD_Estate},
+       {},
+       {Play(C::CARD_Mine), Trash(C::CARD_Copper), Gain(C::CARD_Silver)}},
+      {"Workshop",
+       {C::CARD_Workshop, C::CARD_Estate, C::CARD_Estate, C::CARD_Estate, C::CARD_Estate},
+       {},
+       {Play(C::CARD_Workshop), Gain(C::CARD_Silver)}},
+      {"Moneylender",
+       {C::CARD_Moneylender, C::CARD_Copper, C::CARD_Estate, C::CARD_Estate, C::CARD_Estate},
+       {},
+       {Play(C::CARD_Moneylender)}},
+  };
+}
+
+std::unique_ptr<State> BuildPosition(const Game &game, const CardScenario &sc) {
+  std::unique_ptr<State> state = game.NewInitialState();
+  auto *ds = static_cast<DominionState *>(state.get());
+  // Decks are deep enough that no resolution reshuffles.
+  H::SetCards(ds, 0, sc.hand, CardName::CARD_Copper, 30);
+  std::vector<CardName> opp = sc.opponent_hand;
+  if (opp.empty()) opp.assign(5, CardName::CARD_Copper);
+  H::SetCards(ds, 1, opp, CardName::CARD_Copper, 30);
+  H::StartActionPhase(ds);
+  return state;
+}
+
+// Runs the script once with legality checks so a broken scenario fails
+// loudly instead of timing the wrong path.
+void ValidateScenario(const State &start, const CardScenario &sc) {
+  std::unique_ptr<State> s = start.Clone();
+  for (Action a : sc.script) {
+    std::vector<Action> la = s->LegalActions();
+    if (std::find(la.begin(), la.end(), a) == la.end()) {
+      SpielFatalError(sc.name + ": illegal scripted action " +
+                      s->ActionToString(s->CurrentPlayer(), a));
+    }
+    s->ApplyAction(a);
+  }
+  if (!H::EffectsResolved(static_cast<const DominionState &>(*s))) {
+    SpielFatalError(sc.name + ": effect still pending after script");
+  }
+}
+
+void BenchCardEffect(BenchState &st, const CardScenario &sc) {
+  static std::shared_ptr<const Game> game = LoadGame("dominion");
+  std::unique_ptr<State> start = BuildPosition(*game, sc);
+  ValidateScenario(*start, sc);
+  int64_t actions = 0;
+  for (int64_t i = 0; i < st.iterations(); ++i) {
+    st.PauseTiming();
+    std::unique_ptr<State> s = start->Clone();
+    st.ResumeTiming();
+    for (Action a : sc.script) s->ApplyAction(a);
+    actions += static_cast<int64_t>(sc.script.size());
+    st.PauseTiming();
+    s.reset();
+    st.ResumeTiming();
+  }
+  st.AddCounter("actions", static_cast<double>(actions));
+}
+
+} // namespace
+
+void RegisterCardBenchmarks() {
+  for (CardScenario &sc : Scenarios()) {
+    std::string name = "CardEffect/" + sc.name;
+    RegisterBench(name, [sc = std::move(sc)](BenchState &st) { BenchCardEffect(st, sc); });
+  }
+}
+
+} // namespace bench
+} // namespace dominion
+} // namespace open_spiel
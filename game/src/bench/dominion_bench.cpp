@@ -0,0 +1,519 @@
+// Engine throughput benchmarks. Build with -DCMAKE_BUILD_TYPE=Release and run
+//   ./dominion_bench [--filter=substr] [--min_time=seconds] [--json=path]
+// The JSON output is meant to be diffed across engine changes.
+
+#include <array>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+
+#include "actions.hpp"
+#include "batch_env.hpp"
+#include "bench.hpp"
+#include "count_batch.hpp"
+#include "count_kernels.hpp"
+#include "dominion.hpp"
+#include "heuristic_bots.hpp"
+#include "instrument.hpp"
+#include "mcts.hpp"
+#include "trace.hpp"
+
+namespace open_spiel {
+namespace dominion {
+namespace bench {
+namespace {
+
+// Random playouts are cut off here; random play can stall a game (e.g. when
+// nobody buys victory cards) and would otherwise never end.
+constexpr int kMaxPlayoutMoves = 5000;
+constexpr int kNumSamplePositions = 256;
+// Has Throne Room, trashers, discarders and gainers, so the corpus holds
+// moves of every ActionKind.
+constexpr const char *kChapelThroneKingdom =
+    "Chapel,ThroneRoom,Village,Smithy,Laboratory,Market,Festival,Workshop,"
+    "Cellar,Moneylender";
+
+enum class ActionKind { kPlay, kDiscard, kTrash, kThroneFinish, kEndActions, kBuy, kEndBuy, kGain, kChance };
+
+const char *KindName(ActionKind kind) {
+  switch (kind) {
+    case ActionKind::kPlay: return "Play";
+    case ActionKind::kDiscard: return "DiscardSelect";
+    case ActionKind::kTrash: return "TrashSelect";
+    case ActionKind::kThroneFinish: return "ThroneFinish";
+    case ActionKind::kEndActions: return "EndActions";
+    case ActionKind::kBuy: return "Buy";
+    case ActionKind::kEndBuy: return "EndBuy";
+    case ActionKind::kGain: return "GainSelect";
+    case ActionKind::kChance: return "Shuffle";
+  }
+  return "?";
+}
+
+ActionKind KindOf(Action a) {
+  if (a >= ActionIds::Shuffle()) return ActionKind::kChance;
+  if (a >= ActionIds::GainSelectBase()) return ActionKind::kGain;
+  if (a == ActionIds::EndBuy()) return ActionKind::kEndBuy;
+  if (a >= ActionIds::BuyBase()) return ActionKind::kBuy;
+  if (a == ActionIds::EndActions()) return ActionKind::kEndActions;
+  if (a == ActionIds::ThroneHandSelectFinish()) return ActionKind::kThroneFinish;
+  if (a >= ActionIds::TrashHandBase()) return ActionKind::kTrash;
+  if (a >= ActionIds::DiscardHandBase()) return ActionKind::kDiscard;
+  return ActionKind::kPlay;
+}
+
+struct Corpus {
+  std::shared_ptr<const Game> game;
+  // Non-terminal positions visited by seeded random playouts. Opening hands
+  // and shuffles are chance nodes resolved from the same seeded generator,
+  // so the corpus is identical from run to run.
+  std::vector<std::unique_ptr<State>> states;
+  std::vector<std::string> json;
+  std::vector<std::string> binary;
+  // (position index, action) pairs by action kind.
+  std::vector<std::pair<int, Action>> moves[static_cast<int>(ActionKind::kChance) + 1];
+};
+
+const Corpus &GetCorpus() {
+  static const Corpus *corpus = [] {
+    auto *c = new Corpus;
+    c->game = LoadGame("dominion",
+                       {{"kingdom", GameParameter(std::string(kChapelThroneKingdom))},
+                        {"opening_chance", GameParameter(true)}});
+    std::mt19937 rng(1234);
+    std::unique_ptr<State> state = c->game->NewInitialState();
+    int moves = 0;
+    while (static_cast<int>(c->states.size()) < kNumSamplePositions) {
+      if (state->IsTerminal() || ++moves > kMaxPlayoutMoves) {
+        state = c->game->NewInitialState();
+        moves = 0;
+        continue;
+      }
+      std::vector<Action> la = state->LegalActions();
+      int idx = static_cast<int>(c->states.size());
+      for (Action a : la) c->moves[static_cast<int>(KindOf(a))].push_back({idx, a});
+      c->json.push_back(state->Serialize());
+      c->binary.push_back(static_cast<const DominionState &>(*state).SerializeBinary());
+      c->states.push_back(state->Clone());
+      std::uniform_int_distribution<size_t> pick(0, la.size() - 1);
+      state->ApplyAction(la[pick(rng)]);
+    }
+    return c;
+  }();
+  return *corpus;
+}
+
+const State &Position(int64_t i) {
+  const Corpus &c = GetCorpus();
+  return *c.states[i % c.states.size()];
+}
+
+void BenchLegalActions(BenchState &st) {
+  size_t total = 0;
+  for (int64_t i = 0; i < st.iterations(); ++i) total += Position(i).LegalActions().size();
+  st.AddCounter("legal_actions", static_cast<double>(total));
+}
+
+void BenchClone(BenchState &st) {
+  for (int64_t i = 0; i < st.iterations(); ++i) {
+    std::unique_ptr<State> copy = Position(i).Clone();
+  }
+}
+
+// Clone's counterpart for search: copies into one long-lived state.
+void BenchCopyFrom(BenchState &st) {
+  std::unique_ptr<State> scratch = Position(0).Clone();
+  auto &copy = static_cast<DominionState &>(*scratch);
+  for (int64_t i = 0; i < st.iterations(); ++i) {
+    copy.CopyFrom(static_cast<const DominionState &>(Position(i)));
+  }
+}
+
+void BenchApplyAction(BenchState &st, ActionKind kind) {
+  const Corpus &c = GetCorpus();
+  const auto &moves = c.moves[static_cast<int>(kind)];
+  if (moves.empty()) {
+    st.SetItemsProcessed(0);
+    return;
+  }
+  for (int64_t i = 0; i < st.iterations(); ++i) {
+    const auto &[idx, action] = moves[i % moves.size()];
+    st.PauseTiming();
+    std::unique_ptr<State> copy = c.states[idx]->Clone();
+    st.ResumeTiming();
+    copy->ApplyAction(action);
+    st.PauseTiming();
+    copy.reset();
+    st.ResumeTiming();
+  }
+}
+
+void BenchSerialize(BenchState &st) {
+  size_t bytes = 0;
+  for (int64_t i = 0; i < st.iterations(); ++i) bytes += Position(i).Serialize().size();
+  st.AddCounter("bytes", static_cast<double>(bytes));
+}
+
+void BenchDeserializeState(BenchState &st) {
+  const Corpus &c = GetCorpus();
+  for (int64_t i = 0; i < st.iterations(); ++i) {
+    std::unique_ptr<State> s = c.game->DeserializeState(c.json[i % c.json.size()]);
+  }
+}
+
+void BenchSerializeBinary(BenchState &st) {
+  size_t bytes = 0;
+  for (int64_t i = 0; i < st.iterations(); ++i) {
+    bytes += static_cast<const DominionState &>(Position(i)).SerializeBinary().size();
+  }
+  st.AddCounter("bytes", static_cast<double>(bytes));
+}
+
+void BenchDeserializeBinary(BenchState &st) {
+  const Corpus &c = GetCorpus();
+  const auto &game = static_cast<const DominionGame &>(*c.game);
+  for (int64_t i = 0; i < st.iterations(); ++i) {
+    std::unique_ptr<State> s = game.DeserializeStateBinary(c.binary[i % c.binary.size()]);
+  }
+}
+
+void BenchObservationString(BenchState &st) {
+  for (int64_t i = 0; i < st.iterations(); ++i) {
+    const State &s = Position(i);
+    std::string obs = s.ObservationString(s.IsChanceNode() ? 0 : s.CurrentPlayer());
+  }
+}
+
+// Seeded random games from a reproducible start (opening_chance), each kept
+// as its History() and ForcedMoves().
+struct RecordedGame {
+  std::vector<Action> history;
+  std::vector<ForcedMove> forced;
+};
+constexpr int kNumRecordedGames = 8;
+
+struct RecordedGames {
+  std::shared_ptr<const Game> game;
+  std::vector<RecordedGame> games;
+};
+
+const RecordedGames &GetRecordedGames() {
+  static const RecordedGames *recorded = [] {
+    auto *r = new RecordedGames;
+    r->game = LoadGame("dominion", {{"opening_chance", GameParameter(true)}});
+    std::mt19937 rng(1234);
+    for (int g = 0; g < kNumRecordedGames; ++g) {
+      std::unique_ptr<State> state = r->game->NewInitialState();
+      for (int n = 0; !state->IsTerminal() && n < kMaxPlayoutMoves; ++n) {
+        std::vector<Action> la = state->LegalActions();
+        state->ApplyAction(la[std::uniform_int_distribution<size_t>(0, la.size() - 1)(rng)]);
+      }
+      r->games.push_back(
+          {state->History(), static_cast<const DominionState &>(*state).ForcedMoves()});
+    }
+    return r;
+  }();
+  return *recorded;
+}
+
+// One iteration rebuilds the final state of one recorded game from its start,
+// with ApplyAction (re-deriving forced moves) or ReplayHistory (applying the
+// recorded ones); items are recorded moves.
+void BenchReplay(BenchState &st, bool bulk) {
+  const RecordedGames &r = GetRecordedGames();
+  int64_t moves = 0, forced = 0;
+  for (int64_t i = 0; i < st.iterations(); ++i) {
+    const RecordedGame &g = r.games[i % r.games.size()];
+    st.PauseTiming();
+    std::unique_ptr<State> state = r.game->NewInitialState();
+    st.ResumeTiming();
+    if (bulk) {
+      static_cast<DominionState &>(*state).ReplayHistory(g.history, g.forced);
+    } else {
+      for (Action a : g.history) state->ApplyAction(a);
+    }
+    st.PauseTiming();
+    state.reset();
+    st.ResumeTiming();
+    moves += static_cast<int64_t>(g.history.size());
+    forced += static_cast<int64_t>(g.forced.size());
+  }
+  st.SetItemsProcessed(moves);
+  st.AddCounter("forced_moves", static_cast<double>(forced));
+}
+
+// One iteration is one full game of uniformly random legal moves, chance
+// outcomes included. Items are moves, so ns/op and allocs/op are per move.
+void BenchRandomPlayout(BenchState &st, const GameParameters &params) {
+  std::shared_ptr<const Game> game = LoadGame("dominion", params);
+  std::mt19937 rng(42);
+  int64_t moves = 0, capped = 0;
+  std::vector<Action> la;
+  for (int64_t g = 0; g < st.iterations(); ++g) {
+    trace::GameSpan game_span;
+    std::unique_ptr<State> state = game->NewInitialState();
+    int n = 0;
+    for (; !state->IsTerminal() && n < kMaxPlayoutMoves; ++n) {
+      la = state->LegalActions();
+      std::uniform_int_distribution<size_t> pick(0, la.size() - 1);
+      state->ApplyAction(la[pick(rng)]);
+    }
+    if (!state->IsTerminal()) capped += 1;
+    moves += n;
+  }
+  st.SetItemsProcessed(moves);
+  st.AddCounter("games", static_cast<double>(st.iterations()));
+  st.AddCounter("moves", static_cast<double>(moves));
+  st.AddCounter("capped_games", static_cast<double>(capped));
+}
+
+// One iteration is one full game with `strategy` in both seats; chance
+// outcomes are uniform. Items are moves.
+void BenchHeuristicPlayout(BenchState &st, HeuristicStrategy strategy) {
+  std::shared_ptr<const Game> game = LoadGame(
+      "dominion", {{"kingdom", GameParameter(std::string(
+                                   "Smithy,Militia,Witch,Chapel,Laboratory,Village,Market,"
+                                   "Cellar,Moat,Festival"))}});
+  std::mt19937 rng(42);
+  int64_t moves = 0, capped = 0;
+  for (int64_t g = 0; g < st.iterations(); ++g) {
+    std::unique_ptr<State> state = game->NewInitialState();
+    int n = 0;
+    for (; !state->IsTerminal() && n < kMaxPlayoutMoves; ++n) {
+      if (state->IsChanceNode()) {
+        std::vector<Action> la = state->LegalActions();
+        state->ApplyAction(la[std::uniform_int_distribution<size_t>(0, la.size() - 1)(rng)]);
+      } else {
+        state->ApplyAction(
+            HeuristicAction(static_cast<const DominionState &>(*state), strategy));
+      }
+    }
+    if (!state->IsTerminal()) capped += 1;
+    moves += n;
+  }
+  st.SetItemsProcessed(moves);
+  st.AddCounter("games", static_cast<double>(st.iterations()));
+  st.AddCounter("capped_games", static_cast<double>(capped));
+}
+
+// One iteration is one search of `simulations` simulations from the opening
+// position without tree reuse, on `threads` threads; items are simulations.
+void BenchMctsSearch(BenchState &st, int simulations, int threads) {
+  st.PauseTiming();
+  std::shared_ptr<const Game> game = LoadGame("dominion");
+  std::unique_ptr<State> state = game->NewInitialState();
+  MctsConfig config;
+  config.simulations = simulations;
+  config.num_threads = threads;
+  config.reuse_tree = false;
+  config.seed = 42;
+  MctsSearch search(config);
+  st.ResumeTiming();
+  int64_t nodes = 0;
+  for (int64_t i = 0; i < st.iterations(); ++i) {
+    search.Search(static_cast<const DominionState &>(*state));
+    nodes += search.Stats().nodes;
+  }
+  st.SetItemsProcessed(st.iterations() * simulations);
+  st.AddCounter("nodes", static_cast<double>(nodes));
+}
+
+// One iteration steps every game of a BatchEnv once with uniformly random
+// legal actions (picked from its mask); items are game steps.
+void BenchBatchEnvStep(BenchState &st, int batch_size) {
+  st.PauseTiming();
+  std::shared_ptr<const Game> game =
+      LoadGame("dominion", {{"opening_chance", GameParameter(true)}});
+  BatchEnv env(game, batch_size, 42);
+  st.ResumeTiming();
+  std::mt19937 rng(42);
+  std::vector<Action> actions(batch_size), legal;
+  for (int64_t i = 0; i < st.iterations(); ++i) {
+    st.PauseTiming();
+    for (int g = 0; g < batch_size; ++g) {
+      const uint8_t *mask = env.LegalMask() + static_cast<size_t>(g) * BatchEnv::kLegalMaskStride;
+      legal.clear();
+      for (int a = 0; a < BatchEnv::kLegalMaskStride; ++a) {
+        if (mask[a]) legal.push_back(a);
+      }
+      actions[g] = legal[std::uniform_int_distribution<size_t>(0, legal.size() - 1)(rng)];
+    }
+    st.ResumeTiming();
+    env.Step(actions.data());
+  }
+  st.SetItemsProcessed(st.iterations() * batch_size);
+  st.AddCounter("episodes", static_cast<double>(env.EpisodesCompleted()));
+}
+
+// Bulk count kernels over the corpus positions packed into a CountBatch;
+// items are player rows (game * kNumPlayers + player).
+enum class CountOp { kHandSizes, kTreasureCoins, kMoveHandToDiscard };
+
+void BenchCountBatch(BenchState &st, CountOp op) {
+  st.PauseTiming();
+  const Corpus &c = GetCorpus();
+  int games = static_cast<int>(c.states.size());
+  CountBatch batch(games);
+  for (int g = 0; g < games; ++g) {
+    batch.Load(g, static_cast<const DominionState &>(*c.states[g]));
+  }
+  std::vector<int32_t> out(static_cast<size_t>(games) * kNumPlayers);
+  st.ResumeTiming();
+  for (int64_t i = 0; i < st.iterations(); ++i) {
+    switch (op) {
+    case CountOp::kHandSizes: batch.HandSizes(out.data()); break;
+    case CountOp::kTreasureCoins: batch.TreasureCoins(out.data()); break;
+    case CountOp::kMoveHandToDiscard: batch.MoveHandToDiscard(); break;
+    }
+  }
+  st.SetItemsProcessed(st.iterations() * games * kNumPlayers);
+}
+
+// One pile kernel over the hands of the corpus positions; items are pile
+// arrays. MoveHandToDiscard is measured on copies to keep hands non-empty.
+enum class PileOp { kSum, kMove, kDot };
+
+void BenchPileKernel(BenchState &st, const count_kernels::PileKernels &k, PileOp op) {
+  st.PauseTiming();
+  const Corpus &c = GetCorpus();
+  std::vector<std::array<int, kNumSupplyPiles>> hands, discards;
+  for (const auto &s : c.states) {
+    for (const PlayerState &ps : static_cast<const DominionState &>(*s).player_states_) {
+      hands.push_back(ps.hand_counts_);
+      discards.push_back(ps.discard_counts_);
+    }
+  }
+  std::array<int, kNumSupplyPiles> weights{};
+  for (int j = 0; j < kNumSupplyPiles; ++j) weights[j] = j % 4;
+  std::vector<std::array<int, kNumSupplyPiles>> hand_copy = hands, discard_copy = discards;
+  st.ResumeTiming();
+  int64_t sum = 0;
+  for (int64_t i = 0; i < st.iterations(); ++i) {
+    size_t n = hands.size();
+    switch (op) {
+    case PileOp::kSum:
+      for (size_t h = 0; h < n; ++h) sum += k.sum(hands[h].data());
+      break;
+    case PileOp::kDot:
+      for (size_t h = 0; h < n; ++h) sum += k.dot(hands[h].data(), weights.data());
+      break;
+    case PileOp::kMove:
+      st.PauseTiming();
+      hand_copy = hands;
+      discard_copy = discards;
+      st.ResumeTiming();
+      for (size_t h = 0; h < n; ++h) k.move(discard_copy[h].data(), hand_copy[h].data());
+      break;
+    }
+  }
+  st.SetItemsProcessed(st.iterations() * static_cast<int64_t>(hands.size()));
+  st.AddCounter("checksum", static_cast<double>(sum));
+}
+
+// Per-state baseline for CountBatch/HandSizes.
+void BenchTotalHandSize(BenchState &st) {
+  const Corpus &c = GetCorpus();
+  int64_t sum = 0;
+  for (int64_t i = 0; i < st.iterations(); ++i) {
+    for (const auto &s : c.states) {
+      for (const PlayerState &ps : static_cast<const DominionState &>(*s).player_states_) {
+        sum += ps.TotalHandSize();
+      }
+    }
+  }
+  st.SetItemsProcessed(st.iterations() * static_cast<int64_t>(c.states.size()) * kNumPlayers);
+  st.AddCounter("cards", static_cast<double>(sum));
+}
+
+} // namespace
+
+void RegisterCoreBenchmarks() {
+  RegisterBench("LegalActions", BenchLegalActions);
+  RegisterBench("Clone", BenchClone);
+  RegisterBench("CopyFrom", BenchCopyFrom);
+  for (int k = 0; k <= static_cast<int>(ActionKind::kChance); ++k) {
+    auto kind = static_cast<ActionKind>(k);
+    RegisterBench(std::string("ApplyAction/") + KindName(kind),
+                  [kind](BenchState &st) { BenchApplyAction(st, kind); });
+  }
+  RegisterBench("Serialize", BenchSerialize);
+  RegisterBench("DeserializeState", BenchDeserializeState);
+  RegisterBench("SerializeBinary", BenchSerializeBinary);
+  RegisterBench("DeserializeStateBinary", BenchDeserializeBinary);
+  RegisterBench("ObservationString", BenchObservationString);
+  RegisterBench("Replay/ApplyAction", [](BenchState &st) { BenchReplay(st, false); });
+  RegisterBench("Replay/ReplayHistory", [](BenchState &st) { BenchReplay(st, true); });
+  RegisterBench("RandomPlayout", [](BenchState &st) { BenchRandomPlayout(st, {}); });
+  RegisterBench("RandomPlayout/counts_deck", [](BenchState &st) {
+    BenchRandomPlayout(st, {{"counts_deck", GameParameter(true)}});
+  });
+  // Curated kingdoms stressing different engine paths.
+  const std::pair<const char *, const char *> kingdoms[] = {
+      {"ChapelThrone", kChapelThroneKingdom},
+      {"MilitiaWitch", "Militia,Witch,Moat,Smithy,Village,Market,Laboratory,"
+                       "Cellar,Remodel,Festival"},
+      {"BigMoney", "none"},
+  };
+  for (const auto &[name, kingdom] : kingdoms) {
+    std::string spec = kingdom;
+    RegisterBench(std::string("RandomPlayout/kingdom=") + name, [spec](BenchState &st) {
+      BenchRandomPlayout(st, {{"kingdom", GameParameter(spec)}});
+    });
+  }
+  for (HeuristicStrategy strategy :
+       {HeuristicStrategy::kBigMoney, HeuristicStrategy::kBigMoneySmithy,
+        HeuristicStrategy::kBigMoneyMilitia, HeuristicStrategy::kBigMoneyWitch,
+        HeuristicStrategy::kChapelEngine}) {
+    RegisterBench(std::string("HeuristicPlayout/") + HeuristicStrategyName(strategy),
+                  [strategy](BenchState &st) { BenchHeuristicPlayout(st, strategy); });
+  }
+  for (int sims : {100, 400}) {
+    RegisterBench("MctsSearch/sims=" + std::to_string(sims),
+                  [sims](BenchState &st) { BenchMctsSearch(st, sims, 1); });
+  }
+  for (int threads : {2, 4, 8, 16}) {
+    RegisterBench("MctsSearch/sims=400/threads=" + std::to_string(threads),
+                  [threads](BenchState &st) { BenchMctsSearch(st, 400, threads); });
+  }
+  std::vector<const count_kernels::PileKernels *> pile_kernels = {
+      &count_kernels::ScalarPileKernels()};
+  if (count_kernels::Avx2PileKernels()) pile_kernels.push_back(count_kernels::Avx2PileKernels());
+  for (const count_kernels::PileKernels *k : pile_kernels) {
+    const std::pair<const char *, PileOp> ops[] = {
+        {"Sum", PileOp::kSum}, {"Move", PileOp::kMove}, {"Dot", PileOp::kDot}};
+    for (const auto &[name, op] : ops) {
+      RegisterBench(std::string("PileKernels/") + k->isa + "/" + name,
+                    [k, op = op](BenchState &st) { BenchPileKernel(st, *k, op); });
+    }
+  }
+  RegisterBench("TotalHandSize", BenchTotalHandSize);
+  RegisterBench("CountBatch/HandSizes",
+                [](BenchState &st) { BenchCountBatch(st, CountOp::kHandSizes); });
+  RegisterBench("CountBatch/TreasureCoins",
+                [](BenchState &st) { BenchCountBatch(st, CountOp::kTreasureCoins); });
+  RegisterBench("CountBatch/MoveHandToDiscard",
+                [](BenchState &st) { BenchCountBatch(st, CountOp::kMoveHandToDiscard); });
+  for (int batch : {1, 64}) {
+    RegisterBench("BatchEnvStep/batch=" + std::to_string(batch),
+                  [batch](BenchState &st) { BenchBatchEnvStep(st, batch); });
+  }
+}
+
+} // namespace bench
+} // namespace dominion
+} // namespace open_spiel
+
+int main(int argc, char **argv) {
+  open_spiel::dominion::bench::RegisterCoreBenchmarks();
+  open_spiel::dominion::bench::RegisterCardBenchmarks();
+  int rc = open_spiel::dominion::bench::RunBenchmarks(argc, argv);
+  if (open_spiel::dominion::instrument::Enabled()) {
+    std::printf("\n%s", open_spiel::dominion::instrument::ReportText().c_str());
+  }
+  return rc;
+}
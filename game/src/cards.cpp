@@ -4,6 +4,8 @@
 #include "cards.hpp"
 #include "dominion.hpp"
 #include "actions.hpp"
+#include "instrument.hpp"
+#include "trace.hpp"
 
 namespace open_spiel {
 namespace dominion {
@@ -150,8 +152,7 @@ bool Card::GenericHandSelectionHandler(
       bool should_finish = false;
       if (max_select_count >= 0 && hs->selection_count_value() >= max_select_count) should_finish = true;
       if (finish_on_target_hand_size && hs->target_hand_size_value() > 0) {
-        int hand_sz = 0; for (int k = 0; k < kNumSupplyPiles; ++k) hand_sz += p.hand_counts_[k];
-        if (hand_sz <= hs->target_hand_size_value()) should_finish = true;
+        if (p.TotalHandSize() <= hs->target_hand_size_value()) should_finish = true;
       }
       if (should_finish) {
         if (on_finish) on_finish(st, pl);
@@ -181,6 +182,7 @@ bool Card::GainFromBoardHandler(DominionState& st, int pl, Action action_id) {
     const Card& spec = GetCardSpec(static_cast<CardName>(j));
     if (spec.cost_ <= gs->max_cost) {
       st.player_states_[pl].discard_counts_[j] += 1;
+      st.player_states_[pl].public_cards_.OnGainToDiscard(j);
       st.supply_piles_[j] -= 1;
       p.pending_choice = PendingChoice::None;
       if (!p.effect_queue.empty()) p.effect_queue.pop_front();
@@ -208,6 +210,8 @@ void Card::applyEffect(DominionState&, int) const {}
 // Unified play flow for action cards: apply grants then custom effects.
 void Card::Play(DominionState& state, int player) const {
   applyGrants(state, player);
+  DOMINION_PROBE_SCOPE(instrument::Probe::kEffectHandler);
+  DOMINION_TRACE_SPAN("CardEffect", static_cast<int64_t>(kind_));
   applyEffect(state, player);
 }
 
@@ -215,6 +219,7 @@ void Card::Play(DominionState& state, int player) const {
 // Hand-selection effects expose discard/trash/play actions; gain effects expose
 // legal gains filtered by max_cost and supply availability.
 std::vector<Action> PendingEffectLegalActions(const DominionState& state, int player) {
+  DOMINION_PROBE_SCOPE(instrument::Probe::kPendingEffectLegalActions);
   std::vector<Action> actions;
   const auto& ps = state.player_states_[player];
   if (ps.pending_choice == PendingChoice::DiscardUpToCardsFromHand ||
@@ -284,7 +289,7 @@ void Card::InitBoardSelection(DominionState& state, int player) {
 
 static int AvailableDrawCapacity(const DominionState& st, int pl) {
   const auto& p = st.player_states_[pl];
-  int deck_sz = static_cast<int>(p.deck_.size());
+  int deck_sz = p.DeckSize();
   return deck_sz;
 }
 
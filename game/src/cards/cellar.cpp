@@ -12,6 +12,7 @@ bool CellarCard::CellarHandSelectHandler(DominionState& st, int pl, Action actio
     auto& p2 = st2.player_states_[pl2];
     p2.discard_counts_[j] += 1;
     p2.hand_counts_[j] -= 1;
+    p2.public_cards_.OnDiscardFromHand(j);
   };
   auto on_finish = [](DominionState& st2, int pl2) {
     auto& p2 = st2.player_states_[pl2];
@@ -10,7 +10,10 @@ bool ChapelCard::ChapelHandTrashHandler(DominionState& st, int pl, Action action
   // Trash up to 4; finish early allowed.
   auto on_select = [](DominionState& st2, int pl2, int j) {
     auto& p2 = st2.player_states_[pl2];
-    if (p2.hand_counts_[j] > 0) p2.hand_counts_[j] -= 1;
+    if (p2.hand_counts_[j] > 0) {
+      p2.hand_counts_[j] -= 1;
+      p2.public_cards_.OnTrashFromHand(j);
+    }
   };
   auto on_finish = [](DominionState&, int) {};
   return Card::GenericHandSelectionHandler(st, pl, action_id,
@@ -13,6 +13,7 @@ bool MilitiaCard::MilitiaOpponentDiscardHandler(DominionState& st, int pl, Actio
     if (p2.hand_counts_[j] > 0) {
       p2.discard_counts_[j] += 1;
       p2.hand_counts_[j] -= 1;
+      p2.public_cards_.OnDiscardFromHand(j);
     }
   };
   auto on_finish = [](DominionState& st2, int pl2) {
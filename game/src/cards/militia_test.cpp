@@ -52,6 +52,10 @@ void RunMilitiaTests() {
 
   SPIEL_CHECK_EQ(ds->CurrentPlayer(), 0);
   SPIEL_CHECK_EQ(HandSize(ds, 1), 3);
+  // Both discards were revealed.
+  int known_discard = 0;
+  for (int j = 0; j < kNumSupplyPiles; ++j) known_discard += ds->PublicCards(1).known_discard[j];
+  SPIEL_CHECK_EQ(known_discard, 2);
 }
 
 void RunMilitiaJsonRoundTrip() {
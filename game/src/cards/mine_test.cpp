@@ -55,6 +55,20 @@ void RunMineTests() {
   int hand_silver = ds->player_states_[0].hand_counts_[silver_idx];
   SPIEL_CHECK_EQ(hand_silver, 1);
   SPIEL_CHECK_EQ(SupplyCount(ds, silver_idx), silver_pile_before - 1);
+
+  // No treasure in hand: the only choice is to finish, which ends the effect.
+  {
+    std::unique_ptr<State> s2 = game->NewInitialState();
+    auto* ds2 = dynamic_cast<DominionState*>(s2.get());
+    ds2->player_states_[0].hand_counts_.fill(0);
+    AddCardToHand(ds2, 0, CardName::CARD_Mine);
+    AddCardToHand(ds2, 0, CardName::CARD_Estate);
+    SetPhase(ds2, Phase::actionPhase);
+    ds2->ApplyAction(open_spiel::dominion::ActionIds::PlayHandIndex(static_cast<int>(CardName::CARD_Mine)));
+    SPIEL_CHECK_TRUE(ds2->player_states_[0].pending_choice == PendingChoice::None);
+    SPIEL_CHECK_TRUE(ds2->player_states_[0].effect_queue.empty());
+    SPIEL_CHECK_EQ(ds2->player_states_[0].hand_counts_[static_cast<int>(CardName::CARD_Estate)], 1);
+  }
 }
 
 } } // namespace open_spiel::dominion
@@ -10,6 +10,7 @@ void MoneylenderCard::applyEffect(DominionState& state, int player) const {
   int copper_idx = static_cast<int>(CardName::CARD_Copper);
   if (copper_idx >= 0 && copper_idx < kNumSupplyPiles && ps.hand_counts_[copper_idx] > 0) {
     ps.hand_counts_[copper_idx] -= 1;
+    ps.public_cards_.OnTrashFromHand(copper_idx);
     state.coins_ += 3;
   }
 }
@@ -10,6 +10,13 @@ bool RemodelCard::RemodelTrashFromHand(DominionState& st, int pl, Action action_
   auto& p = st.player_states_[pl];
   if (p.pending_choice != PendingChoice::TrashUpToCardsFromHand) return false;
   EffectNode* node = p.FrontEffect();
+  // Finishing without a selection (offered, e.g., when no card qualifies)
+  // ends the effect; leaving it pending would repeat the same choice forever.
+  if (action_id == ActionIds::TrashHandSelectFinish()) {
+    p.pending_choice = PendingChoice::None;
+    if (!p.effect_queue.empty()) p.effect_queue.pop_front();
+    return true;
+  }
   if (action_id >= ActionIds::TrashHandBase() && action_id < ActionIds::TrashHandBase() + kNumSupplyPiles) {
     int j = static_cast<int>(action_id - ActionIds::TrashHandBase());
     SPIEL_CHECK_TRUE(IsValidPileIndex(j));
@@ -20,6 +27,7 @@ bool RemodelCard::RemodelTrashFromHand(DominionState& st, int pl, Action action_
     int cap = selected.cost_ + 2;
     // Trash selection: remove from hand.
     p.hand_counts_[j] -= 1;
+    p.public_cards_.OnTrashFromHand(j);
     if (hs) const_cast<HandSelectionStruct*>(hs)->set_last_selected_original_index(j);
     // Switch to board gain stage: replace current front effect with gain-from-board.
     auto n = EffectNodeFactory::CreateGainEffect(CardName::CARD_Remodel, cap);
@@ -67,6 +67,24 @@ void RunRemodelTests() {
     SPIEL_CHECK_TRUE(ds2->player_states_[0].effect_queue.empty());
     SPIEL_CHECK_EQ(ds2->actions_, actions_before2 - 1);
   }
+
+  // No card left to trash: the only choice is to finish, which ends the effect.
+  {
+    std::unique_ptr<State> s3 = game->NewInitialState();
+    auto* ds3 = dynamic_cast<DominionState*>(s3.get());
+    ds3->player_states_[0].hand_counts_.fill(0);
+    AddCardToHand(ds3, 0, CardName::CARD_Remodel);
+    AddCardToHand(ds3, 0, CardName::CARD_Estate);
+    SetPhase(ds3, Phase::actionPhase);
+    ds3->ApplyAction(open_spiel::dominion::ActionIds::PlayHandIndex(static_cast<int>(CardName::CARD_Remodel)));
+    ds3->player_states_[0].hand_counts_.fill(0);
+    auto la = ds3->LegalActions();
+    SPIEL_CHECK_EQ(la.size(), 1u);
+    SPIEL_CHECK_EQ(la[0], open_spiel::dominion::ActionIds::TrashHandSelectFinish());
+    ds3->ApplyAction(la[0]);
+    SPIEL_CHECK_TRUE(ds3->player_states_[0].pending_choice == PendingChoice::None);
+    SPIEL_CHECK_TRUE(ds3->player_states_[0].effect_queue.empty());
+  }
 }
 
 void RunRemodelJsonRoundTrip() {
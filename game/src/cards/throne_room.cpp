@@ -7,8 +7,9 @@ namespace dominion {
 
 // ThroneRoomEffectNode methods moved to src/effects.cpp
 
-// Throne Room selection: choose one action card from hand; first play executes
-// grants and effect without spending an action; second play re-applies effect only.
+// Throne Room selection: choose one action card from hand and play it twice
+// without spending an action. A card that opens its own selection (Cellar,
+// Chapel, Remodel, ...) resolves it before its second play.
 bool ThroneRoomCard::ThroneRoomSelectActionHandler(DominionState& st, int pl, Action action_id) {
   auto& p = st.player_states_[pl];
   if (p.pending_choice != PendingChoice::PlayActionFromHand) return false;
@@ -32,15 +33,16 @@ bool ThroneRoomCard::ThroneRoomSelectActionHandler(DominionState& st, int pl, Ac
     }
     // First play: move to play area, do standard grants, no action decrement here.
     p.hand_counts_[j] -= 1;
+    p.public_cards_.OnPlayFromHand(j);
     st.play_area_.push_back(cn);
     // If the selected card is another Throne Room, chain a new selection node for choosing an action.
     if (cn == CardName::CARD_ThroneRoom) {
       if (node) node->StartChain(st, pl);
     } else {
-      // Otherwise, apply the card's own effect twice (Throne effect) and decrement depth once.
-      spec.Play(st, pl);
-      spec.Play(st, pl);
-      if (node) node->ContinueOrFinish(st, pl);
+      // Otherwise play it twice, then decrement the chain depth once.
+      SPIEL_CHECK_TRUE(node != nullptr);
+      node->set_doubling(j, 2);
+      node->PlayDoubled(st, pl);
     }
     return true;
   }
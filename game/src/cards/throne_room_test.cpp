@@ -129,6 +129,68 @@ void RunThroneRoomTests() {
         open_spiel::dominion::ActionIds::PlayHandIndex(static_cast<int>(CardName::CARD_Festival))) != actions.end();
     SPIEL_CHECK_TRUE(can_select_festival);
   }
+
+  // Doubling a card that opens its own selection: the second Cellar play
+  // waits until the first Cellar's discards resolve, then the chain goes on.
+  {
+    std::shared_ptr<const Game> game = LoadGame("dominion");
+    std::unique_ptr<State> state = game->NewInitialState();
+    auto* ds = dynamic_cast<DominionState*>(state.get());
+    SPIEL_CHECK_TRUE(ds != nullptr);
+
+    ds->player_states_[0].hand_counts_.fill(0);
+    AddCardToHand(ds, 0, CardName::CARD_ThroneRoom);
+    AddCardToHand(ds, 0, CardName::CARD_ThroneRoom);
+    AddCardToHand(ds, 0, CardName::CARD_Cellar);
+    AddCardToHand(ds, 0, CardName::CARD_Smithy);
+    AddCardToHand(ds, 0, CardName::CARD_Estate);
+    AddCardToHand(ds, 0, CardName::CARD_Estate);
+    for (int i = 0; i < 10; ++i) AddCardToDeck(ds, 0, CardName::CARD_Copper);
+    SetPhase(ds, Phase::actionPhase);
+    int actions_before = Actions(ds);
+    const int estate = static_cast<int>(CardName::CARD_Estate);
+
+    ds->ApplyAction(open_spiel::dominion::ActionIds::PlayHandIndex(static_cast<int>(CardName::CARD_ThroneRoom)));
+    ds->ApplyAction(open_spiel::dominion::ActionIds::PlayHandIndex(static_cast<int>(CardName::CARD_ThroneRoom)));
+    ds->ApplyAction(open_spiel::dominion::ActionIds::PlayHandIndex(static_cast<int>(CardName::CARD_Cellar)));
+    auto& ps = ds->player_states_[0];
+    SPIEL_CHECK_TRUE(ps.pending_choice == PendingChoice::DiscardUpToCardsFromHand);
+    SPIEL_CHECK_EQ(ps.effect_queue.size(), 2u);
+    auto* parked = dynamic_cast<ThroneRoomEffectNode*>(ps.effect_queue.back().get());
+    SPIEL_CHECK_TRUE(parked != nullptr);
+    SPIEL_CHECK_EQ(parked->plays_left(), 1);
+    SPIEL_CHECK_EQ(PlayAreaSize(ds), 3);
+    SPIEL_CHECK_EQ(Actions(ds), actions_before);  // Throne spent one, Cellar granted one.
+
+    // The waiting Throne Room survives both serializations.
+    std::unique_ptr<State> from_json = game->NewInitialState(nlohmann::json::parse(ds->ToJson()));
+    SPIEL_CHECK_EQ(from_json->ToJson(), ds->ToJson());
+    const auto& dgame = static_cast<const DominionGame&>(*game);
+    SPIEL_CHECK_EQ(dgame.DeserializeStateBinary(ds->SerializeBinary())->ToJson(), ds->ToJson());
+
+    // First Cellar: discard an Estate and draw one.
+    int deck_before = DeckSize(ds, 0);
+    ds->ApplyAction(open_spiel::dominion::ActionIds::DiscardHandSelect(estate));
+    ds->ApplyAction(open_spiel::dominion::ActionIds::DiscardHandSelectFinish());
+    SPIEL_CHECK_EQ(deck_before - DeckSize(ds, 0), 1);
+    // Second Cellar play.
+    SPIEL_CHECK_TRUE(ps.pending_choice == PendingChoice::DiscardUpToCardsFromHand);
+    SPIEL_CHECK_EQ(ps.effect_queue.size(), 2u);
+    SPIEL_CHECK_EQ(Actions(ds), actions_before + 1);
+    ds->ApplyAction(open_spiel::dominion::ActionIds::DiscardHandSelect(estate));
+    ds->ApplyAction(open_spiel::dominion::ActionIds::DiscardHandSelectFinish());
+    SPIEL_CHECK_EQ(deck_before - DeckSize(ds, 0), 2);
+    SPIEL_CHECK_EQ(ps.discard_counts_[estate], 2);
+
+    // The outer Throne Room picks again: Smithy twice.
+    SPIEL_CHECK_TRUE(ps.pending_choice == PendingChoice::PlayActionFromHand);
+    SPIEL_CHECK_EQ(ps.effect_queue.size(), 1u);
+    ds->ApplyAction(open_spiel::dominion::ActionIds::PlayHandIndex(static_cast<int>(CardName::CARD_Smithy)));
+    SPIEL_CHECK_EQ(deck_before - DeckSize(ds, 0), 8);
+    SPIEL_CHECK_TRUE(ps.pending_choice == PendingChoice::None);
+    SPIEL_CHECK_TRUE(ps.effect_queue.empty());
+    SPIEL_CHECK_EQ(PlayAreaSize(ds), 4);
+  }
 }
 
 void RunThroneRoomJsonRoundTrip() {
@@ -12,6 +12,7 @@ void WitchCard::WitchAttackGiveCurse(DominionState& st, int player) {
   SPIEL_CHECK_TRUE(curse_idx >= 0 && curse_idx < kNumSupplyPiles);
   if (st.supply_piles_[curse_idx] > 0) {
     st.player_states_[opp].discard_counts_[curse_idx] += 1;
+    st.player_states_[opp].public_cards_.OnGainToDiscard(curse_idx);
     st.supply_piles_[curse_idx] -= 1;
   }
 }
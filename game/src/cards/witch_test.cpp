@@ -42,6 +42,8 @@ void RunWitchTests() {
   SPIEL_CHECK_EQ(HandSize(ds, 0), hand_before_p0 + 1);
   SPIEL_CHECK_EQ(DiscardSize(ds, 1), opp_discard_before + 1);
   SPIEL_CHECK_EQ(SupplyCount(ds, curse_idx), curse_supply_before - 1);
+  SPIEL_CHECK_EQ(ds->PublicCards(1).owned[curse_idx], 1);
+  SPIEL_CHECK_EQ(ds->PublicCards(1).known_discard[curse_idx], 1);
 }
 
 void RunWitchJsonRoundTrip() {
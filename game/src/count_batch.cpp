@@ -0,0 +1,120 @@
+#include "count_batch.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include "cards.hpp"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace dominion {
+
+namespace {
+
+void PackRow(const std::array<int, kNumSupplyPiles> &counts, uint8_t *row) {
+  for (int j = 0; j < kNumSupplyPiles; ++j) {
+    SPIEL_CHECK_GE(counts[j], 0);
+    SPIEL_CHECK_LE(counts[j], 255);
+    row[j] = static_cast<uint8_t>(counts[j]);
+  }
+}
+
+void UnpackRow(const uint8_t *row, std::array<int, kNumSupplyPiles> *counts) {
+  for (int j = 0; j < kNumSupplyPiles; ++j) (*counts)[j] = row[j];
+}
+
+} // namespace
+
+const uint8_t *BasicTreasureValueRow() {
+  alignas(kCountRowBytes) static const auto row = [] {
+    std::array<uint8_t, kCountRowBytes> r{};
+    for (int j = 0; j < kNumSupplyPiles; ++j) {
+      const Card &spec = GetCardSpec(static_cast<CardName>(j));
+      bool basic = std::find(spec.types_.begin(), spec.types_.end(),
+                             CardType::BASIC_TREASURE) != spec.types_.end();
+      if (basic) r[j] = static_cast<uint8_t>(spec.value_);
+    }
+    return r;
+  }();
+  return row.data();
+}
+
+namespace {
+int CheckedNumGames(int num_games) {
+  SPIEL_CHECK_GT(num_games, 0);
+  return num_games;
+}
+} // namespace
+
+CountBatch::CountBatch(int num_games)
+    : num_games_(CheckedNumGames(num_games)), hand_(AllocateRows(num_games * kNumPlayers)),
+      discard_(AllocateRows(num_games * kNumPlayers)), play_(AllocateRows(num_games)),
+      supply_(AllocateRows(num_games)) {}
+
+CountBatch::Block CountBatch::AllocateRows(int rows) {
+  size_t bytes = static_cast<size_t>(rows) * kCountRowBytes;
+  auto *p = static_cast<uint8_t *>(std::aligned_alloc(kCountRowBytes, bytes));
+  if (!p) SpielFatalError("CountBatch: out of memory");
+  std::memset(p, 0, bytes);
+  return Block(p);
+}
+
+void CountBatch::Load(int game, const DominionState &state) {
+  for (int p = 0; p < kNumPlayers; ++p) {
+    PackRow(state.player_states_[p].hand_counts_, Hand(game, p));
+    PackRow(state.player_states_[p].discard_counts_, Discard(game, p));
+  }
+  PackRow(state.supply_piles_, Supply(game));
+  uint8_t *play = PlayArea(game);
+  std::memset(play, 0, kCountRowBytes);
+  for (CardName cn : state.play_area_) play[static_cast<int>(cn)] += 1;
+}
+
+void CountBatch::Store(int game, DominionState *state) const {
+  const uint8_t *play = PlayArea(game);
+  const bool play_emptied =
+      std::all_of(play, play + kCountRowBytes, [](uint8_t c) { return c == 0; });
+  for (int p = 0; p < kNumPlayers; ++p) {
+    PlayerState &ps = state->player_states_[p];
+    UnpackRow(Hand(game, p), &ps.hand_counts_);
+    UnpackRow(Discard(game, p), &ps.discard_counts_);
+    // The bulk operations only move cards from hand and play area into the
+    // discard; the known ones stay known there (as in OnCleanup).
+    PublicCardTracker &known = ps.public_cards_;
+    for (int j = 0; j < kNumSupplyPiles; ++j) {
+      int moved = std::max(0, known.known_hand[j] - ps.hand_counts_[j]);
+      known.known_hand[j] -= moved;
+      if (play_emptied) {
+        moved += known.in_play[j];
+        known.in_play[j] = 0;
+      }
+      known.known_discard[j] = std::min(known.known_discard[j] + moved, ps.discard_counts_[j]);
+    }
+  }
+  UnpackRow(Supply(game), &state->supply_piles_);
+  if (play_emptied) state->play_area_.clear();
+}
+
+void CountBatch::MoveHandToDiscard() {
+  count_kernels::MoveRows(discard_.get(), hand_.get(), num_games_ * kNumPlayers);
+}
+
+void CountBatch::CleanupMerge(const int32_t *player) {
+  for (int g = 0; g < num_games_; ++g) {
+    SPIEL_CHECK_GE(player[g], 0);
+    SPIEL_CHECK_LT(player[g], kNumPlayers);
+    count_kernels::MergeRows(Discard(g, player[g]), Hand(g, player[g]), PlayArea(g), 1);
+  }
+}
+
+void CountBatch::HandSizes(int32_t *out) const {
+  count_kernels::RowSums(hand_.get(), num_games_ * kNumPlayers, out);
+}
+
+void CountBatch::TreasureCoins(int32_t *out) const {
+  count_kernels::RowDots(hand_.get(), BasicTreasureValueRow(), num_games_ * kNumPlayers, out);
+}
+
+} // namespace dominion
+} // namespace open_spiel
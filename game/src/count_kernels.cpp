@@ -0,0 +1,201 @@
+#include "count_kernels.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define DOMINION_HAVE_AVX2_KERNELS 1
+#endif
+
+namespace open_spiel {
+namespace dominion {
+namespace count_kernels {
+
+namespace {
+
+// Piles covered by full 8-lane vectors; the rest are done one by one.
+constexpr int kVectorPiles = kPileWidth / 8 * 8;
+
+int SumScalar(const int *counts) {
+  int total = 0;
+  for (int j = 0; j < kPileWidth; ++j) total += counts[j];
+  return total;
+}
+
+void MoveScalar(int *dst, int *src) {
+  for (int j = 0; j < kPileWidth; ++j) {
+    dst[j] += src[j];
+    src[j] = 0;
+  }
+}
+
+int DotScalar(const int *counts, const int *weights) {
+  int total = 0;
+  for (int j = 0; j < kPileWidth; ++j) total += counts[j] * weights[j];
+  return total;
+}
+
+constexpr PileKernels kScalar = {"scalar", SumScalar, MoveScalar, DotScalar};
+
+#ifdef DOMINION_HAVE_AVX2_KERNELS
+__attribute__((target("avx2"))) inline int HorizontalSum(__m256i v) {
+  __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+  s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4e));
+  s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xb1));
+  return _mm_cvtsi128_si32(s);
+}
+
+__attribute__((target("avx2"))) int SumAvx2(const int *counts) {
+  __m256i acc = _mm256_setzero_si256();
+  for (int j = 0; j < kVectorPiles; j += 8) {
+    acc = _mm256_add_epi32(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(counts + j)));
+  }
+  int total = HorizontalSum(acc);
+  for (int j = kVectorPiles; j < kPileWidth; ++j) total += counts[j];
+  return total;
+}
+
+__attribute__((target("avx2"))) void MoveAvx2(int *dst, int *src) {
+  const __m256i zero = _mm256_setzero_si256();
+  for (int j = 0; j < kVectorPiles; j += 8) {
+    auto *d = reinterpret_cast<__m256i *>(dst + j);
+    auto *s = reinterpret_cast<__m256i *>(src + j);
+    _mm256_storeu_si256(d, _mm256_add_epi32(_mm256_loadu_si256(d), _mm256_loadu_si256(s)));
+    _mm256_storeu_si256(s, zero);
+  }
+  for (int j = kVectorPiles; j < kPileWidth; ++j) {
+    dst[j] += src[j];
+    src[j] = 0;
+  }
+}
+
+__attribute__((target("avx2"))) int DotAvx2(const int *counts, const int *weights) {
+  __m256i acc = _mm256_setzero_si256();
+  for (int j = 0; j < kVectorPiles; j += 8) {
+    __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(counts + j));
+    __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(weights + j));
+    acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(c, w));
+  }
+  int total = HorizontalSum(acc);
+  for (int j = kVectorPiles; j < kPileWidth; ++j) total += counts[j] * weights[j];
+  return total;
+}
+
+constexpr PileKernels kAvx2 = {"avx2", SumAvx2, MoveAvx2, DotAvx2};
+#endif
+
+const PileKernels *SelectPileKernels() {
+  const PileKernels *best = Avx2PileKernels();
+  return best ? best : &kScalar;
+}
+
+} // namespace
+
+// Constant-initialized to the scalar kernels so code running during static
+// initialization is safe; upgraded below once the CPU has been checked.
+const PileKernels *internal::active = &kScalar;
+
+namespace {
+[[maybe_unused]] const bool kPileKernelsSelected = (internal::active = SelectPileKernels(), true);
+} // namespace
+
+const PileKernels &ScalarPileKernels() { return kScalar; }
+
+const PileKernels *Avx2PileKernels() {
+#ifdef DOMINION_HAVE_AVX2_KERNELS
+  if (__builtin_cpu_supports("avx2")) return &kAvx2;
+#endif
+  return nullptr;
+}
+
+const PileKernels &ActivePileKernels() { return *internal::active; }
+
+void SetActivePileKernels(const PileKernels &kernels) { internal::active = &kernels; }
+
+void MoveRows(uint8_t *__restrict dst, uint8_t *__restrict src, int rows) {
+  for (int r = 0; r < rows; ++r) {
+    uint8_t *d = dst + static_cast<size_t>(r) * kCountRowBytes;
+    uint8_t *s = src + static_cast<size_t>(r) * kCountRowBytes;
+    for (int j = 0; j < kCountRowBytes; ++j) {
+      d[j] = static_cast<uint8_t>(d[j] + s[j]);
+      s[j] = 0;
+    }
+  }
+}
+
+void MergeRows(uint8_t *__restrict dst, uint8_t *__restrict a, uint8_t *__restrict b,
+               int rows) {
+  for (int r = 0; r < rows; ++r) {
+    uint8_t *d = dst + static_cast<size_t>(r) * kCountRowBytes;
+    uint8_t *x = a + static_cast<size_t>(r) * kCountRowBytes;
+    uint8_t *y = b + static_cast<size_t>(r) * kCountRowBytes;
+    for (int j = 0; j < kCountRowBytes; ++j) {
+      d[j] = static_cast<uint8_t>(d[j] + x[j] + y[j]);
+      x[j] = 0;
+      y[j] = 0;
+    }
+  }
+}
+
+// Compilers do not turn the widening reductions below into psadbw/pmaddwd,
+// so they are written with SSE2 (always present on x86-64).
+void RowSums(const uint8_t *src, int rows, int32_t *out) {
+#if defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  for (int r = 0; r < rows; ++r) {
+    auto *s = reinterpret_cast<const __m128i *>(src + static_cast<size_t>(r) * kCountRowBytes);
+    // psadbw against zero sums each 8-byte half into a 64-bit lane.
+    __m128i a = _mm_add_epi64(_mm_sad_epu8(_mm_load_si128(s), zero),
+                              _mm_sad_epu8(_mm_load_si128(s + 1), zero));
+    __m128i b = _mm_add_epi64(_mm_sad_epu8(_mm_load_si128(s + 2), zero),
+                              _mm_sad_epu8(_mm_load_si128(s + 3), zero));
+    a = _mm_add_epi64(a, b);
+    a = _mm_add_epi64(a, _mm_unpackhi_epi64(a, a));
+    out[r] = _mm_cvtsi128_si32(a);
+  }
+#else
+  for (int r = 0; r < rows; ++r) {
+    const uint8_t *s = src + static_cast<size_t>(r) * kCountRowBytes;
+    uint16_t total = 0; // at most 64 * 255
+    for (int j = 0; j < kCountRowBytes; ++j) total = static_cast<uint16_t>(total + s[j]);
+    out[r] = total;
+  }
+#endif
+}
+
+void RowDots(const uint8_t *src, const uint8_t *weights, int rows, int32_t *out) {
+#if defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  __m128i w_lo[4], w_hi[4];
+  for (int k = 0; k < 4; ++k) {
+    __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i *>(weights) + k);
+    w_lo[k] = _mm_unpacklo_epi8(w, zero);
+    w_hi[k] = _mm_unpackhi_epi8(w, zero);
+  }
+  for (int r = 0; r < rows; ++r) {
+    auto *s = reinterpret_cast<const __m128i *>(src + static_cast<size_t>(r) * kCountRowBytes);
+    __m128i acc = zero;
+    for (int k = 0; k < 4; ++k) {
+      __m128i x = _mm_load_si128(s + k);
+      acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpacklo_epi8(x, zero), w_lo[k]));
+      acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpackhi_epi8(x, zero), w_hi[k]));
+    }
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0x4e));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0xb1));
+    out[r] = _mm_cvtsi128_si32(acc);
+  }
+#else
+  for (int r = 0; r < rows; ++r) {
+    const uint8_t *s = src + static_cast<size_t>(r) * kCountRowBytes;
+    int32_t total = 0;
+    for (int j = 0; j < kCountRowBytes; ++j) total += s[j] * weights[j];
+    out[r] = total;
+  }
+#endif
+}
+
+
+} // namespace count_kernels
+} // namespace dominion
+} // namespace open_spiel
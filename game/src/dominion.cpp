@@ -2,10 +2,13 @@
 #include <cstdlib>
 #include <map>
 #include <random>
+#include <utility>
 
 #include "actions.hpp"
 #include "cards.hpp"
 #include "dominion.hpp"
+#include "instrument.hpp"
+#include "trace.hpp"
 #include "open_spiel/spiel.h"
 
 namespace open_spiel {
@@ -29,7 +32,50 @@ const GameType kGameType{
     /*provides_information_state_tensor=*/false,
     /*provides_observation_string=*/true,
     /*provides_observation_tensor=*/false,
-    /*parameter_specification=*/{}};
+    /*parameter_specification=*/{
+        // Enumerate draws as chance outcomes instead of sampling shuffles.
+        {"explicit_chance", GameParameter(false)},
+        // Store draw piles as card counts and sample each draw lazily.
+        {"counts_deck", GameParameter(false)},
+        // Deal opening hands through shuffle chance nodes.
+        {"opening_chance", GameParameter(false)},
+        // Comma-separated kingdom card names (e.g. "Chapel,ThroneRoom");
+        // empty selects kDefaultKingdom, "none" plays basic cards only.
+        {"kingdom", GameParameter(std::string(""))},
+    }};
+
+std::vector<CardName> ParseKingdom(const std::string &spec) {
+  if (spec.empty()) return {kDefaultKingdom.begin(), kDefaultKingdom.end()};
+  std::vector<CardName> kingdom;
+  if (spec == "none") return kingdom;
+  size_t start = 0;
+  while (start <= spec.size()) {
+    size_t end = spec.find(',', start);
+    if (end == std::string::npos) end = spec.size();
+    std::string name = spec.substr(start, end - start);
+    int found = -1;
+    for (int j = static_cast<int>(CardName::CARD_Curse) + 1; j < kNumSupplyPiles; ++j) {
+      if (GetCardSpec(static_cast<CardName>(j)).name_ == name) found = j;
+    }
+    if (found < 0) SpielFatalError("Unknown kingdom card: '" + name + "'");
+    CardName cn = static_cast<CardName>(found);
+    if (std::find(kingdom.begin(), kingdom.end(), cn) != kingdom.end()) {
+      SpielFatalError("Duplicate kingdom card: " + name);
+    }
+    kingdom.push_back(cn);
+    start = end + 1;
+  }
+  return kingdom;
+}
+
+GameType GameTypeForParams(const GameParameters &params) {
+  GameType type = kGameType;
+  auto it = params.find("explicit_chance");
+  if (it != params.end() && it->second.bool_value()) {
+    type.chance_mode = GameType::ChanceMode::kExplicitStochastic;
+  }
+  return type;
+}
 
 std::shared_ptr<const Game> Factory(const GameParameters &params) {
   return std::shared_ptr<const Game>(new DominionGame(params));
@@ -40,8 +86,17 @@ REGISTER_SPIEL_GAME(kGameType, Factory);
 } // namespace
 
 DominionGame::DominionGame(const GameParameters &params)
-    : Game(kGameType, params) {
+    : Game(GameTypeForParams(params), params) {
   // No game-level RNG management; chance events use local RNG.
+  explicit_chance_ =
+      GetType().chance_mode == GameType::ChanceMode::kExplicitStochastic;
+  auto it = params.find("counts_deck");
+  counts_deck_ = explicit_chance_ || (it != params.end() && it->second.bool_value());
+  // Explicit-chance mode already deals opening hands by chance nodes.
+  it = params.find("opening_chance");
+  opening_chance_ = !explicit_chance_ && it != params.end() && it->second.bool_value();
+  it = params.find("kingdom");
+  kingdom_ = ParseKingdom(it != params.end() ? it->second.string_value() : "");
 }
 
 int DominionGame::NumDistinctActions() const {
@@ -66,13 +121,16 @@ std::vector<int> DominionGame::ObservationTensorShape() const { return {}; }
 
 int DominionGame::MaxGameLength() const { return 500; }
 
-int DominionGame::MaxChanceOutcomes() const { return 1; }
+int DominionGame::MaxChanceOutcomes() const {
+  return explicit_chance_ ? kMaxDrawOutcomes : kNumShuffleSeeds;
+}
 
 std::unique_ptr<State> DominionGame::NewInitialState(const json &j) const {
   return std::unique_ptr<State>(new DominionState(shared_from_this(), j));
 }
 
 std::unique_ptr<State> DominionGame::DeserializeState(const std::string &str) const {
+  DOMINION_PROBE_SCOPE(instrument::Probe::kDeserializeJson);
   json j = json::parse(str);
   return std::unique_ptr<State>(new DominionState(shared_from_this(), j));
 }
@@ -82,32 +140,204 @@ static bool HasType(const Card &c, CardType t) {
   return std::find(c.types_.begin(), c.types_.end(), t) != c.types_.end();
 }
 
+// Coin value of each basic treasure by pile, zero elsewhere.
+const std::array<int, kNumSupplyPiles> &BasicTreasureValues() {
+  static const auto values = [] {
+    std::array<int, kNumSupplyPiles> v{};
+    for (int j = 0; j < kNumSupplyPiles; ++j) {
+      const Card &spec = GetCardSpec(static_cast<CardName>(j));
+      if (HasType(spec, CardType::BASIC_TREASURE)) v[j] = spec.value_;
+    }
+    return v;
+  }();
+  return values;
+}
+
 // Format an action as "id:name" using the game's action-naming helpers.
 static std::string FormatActionPair(const DominionState& st, Action a) {
   return std::to_string(static_cast<int>(a)) + ":" + st.ActionToString(st.CurrentPlayer(), a);
 }
+
+// The last action as players see it. A chance outcome (shuffle seed or
+// explicit draw) fixes hidden card order, so only its kind is shown.
+static std::string FormatLastAction(const DominionState& st, const State::PlayerAction& last) {
+  if (last.player == kChancePlayerId) return st.ExplicitChance() ? "Draw" : "Shuffle";
+  return FormatActionPair(st, last.action);
+}
+
+// Explicit-chance draws. A draw of m cards from an unordered deck is
+// identified by how many of each card type it contains; its probability is
+// the multivariate hypergeometric prod_j C(n_j, x_j) / C(d, m).
+double Choose(int n, int k) {
+  if (k < 0 || k > n) return 0.0;
+  k = std::min(k, n - k);
+  double r = 1.0;
+  for (int i = 1; i <= k; ++i) r = r * (n - k + i) / i;
+  return r;
+}
+
+// Number of distinct draws of m <= kMaxDrawChunk cards, saturating just above
+// kMaxDrawOutcomes.
+int CountDrawOutcomes(const std::array<int, kNumSupplyPiles> &counts, int m) {
+  std::array<int64_t, kMaxDrawChunk + 1> ways{};
+  ways[0] = 1;
+  for (int j = 0; j < kNumSupplyPiles; ++j) {
+    if (counts[j] == 0) continue;
+    std::array<int64_t, kMaxDrawChunk + 1> next{};
+    for (int s = 0; s <= m; ++s) {
+      if (ways[s] == 0) continue;
+      for (int x = 0; x <= counts[j] && s + x <= m; ++x) {
+        next[s + x] = std::min<int64_t>(next[s + x] + ways[s], kMaxDrawOutcomes + 1);
+      }
+    }
+    ways = next;
+  }
+  return static_cast<int>(ways[m]);
+}
+
+template <typename Fn>
+bool VisitDraws(const std::array<int, kNumSupplyPiles> &counts,
+                const std::array<int, kNumSupplyPiles + 1> &suffix, int j,
+                int remaining, double ways, double denom,
+                std::array<int, kNumSupplyPiles> &draw, Fn &fn) {
+  if (remaining == 0) return fn(draw, ways / denom);
+  int hi = std::min(counts[j], remaining);
+  int lo = std::max(0, remaining - suffix[j + 1]);
+  for (int x = hi; x >= lo; --x) {
+    draw[j] = x;
+    if (!VisitDraws(counts, suffix, j + 1, remaining - x,
+                    ways * Choose(counts[j], x), denom, draw, fn)) {
+      draw[j] = 0;
+      return false;
+    }
+  }
+  draw[j] = 0;
+  return true;
+}
+
+// Visits the draws of m cards in a fixed order (card types ascending, larger
+// counts first). fn(draw, probability) returns false to stop early.
+template <typename Fn>
+void ForEachDraw(const std::array<int, kNumSupplyPiles> &counts, int m, Fn fn) {
+  std::array<int, kNumSupplyPiles + 1> suffix{};
+  for (int j = kNumSupplyPiles - 1; j >= 0; --j) suffix[j] = suffix[j + 1] + counts[j];
+  if (m <= 0 || m > suffix[0]) return;
+  std::array<int, kNumSupplyPiles> draw{};
+  VisitDraws(counts, suffix, 0, m, 1.0, Choose(suffix[0], m), draw, fn);
+}
 } // namespace
 
+int DominionState::DrawPlayer() const {
+  for (int p = 0; p < kNumPlayers; ++p) {
+    if (pending_draws_[p] > 0) return p;
+  }
+  return kInvalidPlayer;
+}
+
+// Largest number of pending cards one chance node can resolve while keeping
+// its outcome count within kMaxDrawOutcomes.
+int DominionState::DrawChunkSize(int player) const {
+  const auto &ps = player_states_[player];
+  int m = std::min({pending_draws_[player], ps.DeckSize(), kMaxDrawChunk});
+  while (m > 1 && CountDrawOutcomes(ps.deck_counts_, m) > kMaxDrawOutcomes) --m;
+  return m;
+}
+
+// Applies draws that have a single possible outcome (known top cards, the
+// whole deck, or a deck of one card type) and reshuffles empty decks, so a
+// chance node remains only where the draw is uncertain.
+void DominionState::SettlePendingDraws() {
+  for (int p = 0; p < kNumPlayers; ++p) {
+    auto &ps = player_states_[p];
+    while (pending_draws_[p] > 0) {
+      if (!ps.deck_.empty()) {
+        ps.hand_counts_[ps.DrawTopCard()] += 1;
+        pending_draws_[p] -= 1;
+        continue;
+      }
+      int deck_size = ps.DeckSize();
+      if (deck_size == 0) {
+        if (ps.TotalDiscardSize() == 0) {
+          pending_draws_[p] = 0;
+          break;
+        }
+        // Deck order is not tracked, so the reshuffle is a count merge.
+        DOMINION_PROBE_COUNT(instrument::Probe::kShuffle);
+        count_kernels::MovePiles(ps.deck_counts_.data(), ps.discard_counts_.data());
+        ps.public_cards_.OnReshuffle();
+        continue;
+      }
+      int m = std::min(pending_draws_[p], deck_size);
+      int types = 0;
+      for (int j = 0; j < kNumSupplyPiles; ++j) types += ps.deck_counts_[j] > 0;
+      if (m < deck_size && types > 1) break;
+      for (int j = 0; j < kNumSupplyPiles; ++j) {
+        int take = std::min(m, ps.deck_counts_[j]);
+        ps.deck_counts_[j] -= take;
+        ps.hand_counts_[j] += take;
+        m -= take;
+        pending_draws_[p] -= take;
+      }
+    }
+  }
+}
+
+bool DominionState::DecodeDrawOutcome(Action action_id,
+                                      std::array<int, kNumSupplyPiles> *draw) const {
+  int p = DrawPlayer();
+  if (p == kInvalidPlayer) return false;
+  int target = static_cast<int>(action_id - ActionIds::DrawOutcome(0));
+  int index = 0;
+  bool found = false;
+  ForEachDraw(player_states_[p].deck_counts_, DrawChunkSize(p),
+              [&](const std::array<int, kNumSupplyPiles> &d, double) {
+                if (index++ != target) return true;
+                *draw = d;
+                found = true;
+                return false;
+              });
+  return found;
+}
+
+void DominionState::ApplyDrawOutcome(Action action_id) {
+  int p = DrawPlayer();
+  SPIEL_CHECK_NE(p, kInvalidPlayer);
+  std::array<int, kNumSupplyPiles> draw{};
+  SPIEL_CHECK_TRUE(DecodeDrawOutcome(action_id, &draw));
+  auto &ps = player_states_[p];
+  for (int j = 0; j < kNumSupplyPiles; ++j) {
+    ps.deck_counts_[j] -= draw[j];
+    ps.hand_counts_[j] += draw[j];
+    pending_draws_[p] -= draw[j];
+  }
+  SettlePendingDraws();
+}
+
 void DominionState::DrawCardsFor(int player, int n) {
+  DOMINION_PROBE_SCOPE(instrument::Probe::kDrawCardsFor);
   auto &ps = player_states_[player];
+  if (explicit_chance_) {
+    pending_draws_[player] += n;
+    SettlePendingDraws();
+    return;
+  }
   for (int i = 0; i < n; ++i) {
-    if (ps.deck_.empty()) {
-      int discard_size = 0; for (int jj=0;jj<kNumSupplyPiles;++jj) discard_size += ps.discard_counts_[jj];
-      if (discard_size == 0) break;
+    if (ps.DeckSize() == 0) {
+      if (ps.TotalDiscardSize() == 0) break;
       shuffle_pending_ = true;
       original_player_for_shuffle_ = player;
       pending_draw_count_after_shuffle_ = n - i;
       return;
     }
-    int idx = static_cast<int>(ps.deck_.back());
-    if (idx >= 0 && idx < kNumSupplyPiles) {
-      ps.hand_counts_[idx] += 1;
-    }
-    ps.deck_.pop_back();
+    ps.hand_counts_[ps.DrawTopCard()] += 1;
   }
 }
 
 DominionState::DominionState(std::shared_ptr<const Game> game) : State(game) {
+  const auto &dgame = static_cast<const DominionGame &>(*game);
+  explicit_chance_ = dgame.ExplicitChance();
+  counts_deck_ = dgame.CountsDeck();
+  opening_chance_ = dgame.OpeningChance();
   // Shuffle initial decks using a local RNG to introduce chance.
   unsigned seed = static_cast<unsigned>(std::random_device{}());
   std::mt19937 rng(seed);
@@ -121,32 +351,44 @@ DominionState::DominionState(std::shared_ptr<const Game> game) : State(game) {
   supply_piles_[static_cast<int>(CardName::CARD_Duchy)] = 8;
   supply_piles_[static_cast<int>(CardName::CARD_Province)] = 8;
   supply_piles_[static_cast<int>(CardName::CARD_Curse)] = 10;
-  std::array<CardName, 10> kingdom = {CardName::CARD_Cellar,  CardName::CARD_Market,  CardName::CARD_Militia,
-                                      CardName::CARD_Moneylender,    CardName::CARD_Moat,    CardName::CARD_Remodel,
-                                      CardName::CARD_Smithy,  CardName::CARD_Merchant, CardName::CARD_Workshop,
-                                      CardName::CARD_Mine};
-  for (CardName cn : kingdom) supply_piles_[static_cast<int>(cn)] = 10;
+  for (CardName cn : dgame.Kingdom()) supply_piles_[static_cast<int>(cn)] = 10;
   initial_supply_piles_ = supply_piles_;
 
   // Initial decks and hands
   for (int p = 0; p < kNumPlayers; ++p) {
     auto &ps = player_states_[p];
     ps.deck_.clear();
+    ps.deck_counts_.fill(0);
     ps.discard_counts_.fill(0);
     ps.hand_counts_.fill(0);
-    ps.obs_state =
-        std::make_unique<ObservationState>(ps.hand_counts_, ps.deck_, ps.discard_counts_);
-    for (int i = 0; i < 7; ++i) {
-      ps.deck_.push_back(CardName::CARD_Copper);
-    }
-    for (int i = 0; i < 3; ++i) {
-      ps.deck_.push_back(CardName::CARD_Estate);
+    ps.public_cards_ = PublicCardTracker{};
+    ps.public_cards_.owned[static_cast<int>(CardName::CARD_Copper)] = 7;
+    ps.public_cards_.owned[static_cast<int>(CardName::CARD_Estate)] = 3;
+    ps.ResetObsState();
+    if (opening_chance_) {
+      // Dealt by DealOpeningHands through each player's first shuffle.
+      ps.discard_counts_[static_cast<int>(CardName::CARD_Copper)] = 7;
+      ps.discard_counts_[static_cast<int>(CardName::CARD_Estate)] = 3;
+    } else if (counts_deck_) {
+      // Unordered starting deck; draws sample from it (or, in explicit-chance
+      // mode, the opening hands are dealt by chance nodes).
+      ps.deck_counts_[static_cast<int>(CardName::CARD_Copper)] = 7;
+      ps.deck_counts_[static_cast<int>(CardName::CARD_Estate)] = 3;
+      ps.deck_rng_ = static_cast<uint64_t>(rng()) << 32 | rng();
+    } else {
+      for (int i = 0; i < 7; ++i) {
+        ps.deck_.push_back(CardName::CARD_Copper);
+      }
+      for (int i = 0; i < 3; ++i) {
+        ps.deck_.push_back(CardName::CARD_Estate);
+      }
+      // Shuffle the 10-card starting deck using local RNG.
+      std::shuffle(ps.deck_.begin(), ps.deck_.end(), rng);
     }
-    // Shuffle the 10-card starting deck using local RNG.
-    std::shuffle(ps.deck_.begin(), ps.deck_.end(), rng);
 
-    DrawCardsFor(p, 5);
+    if (!opening_chance_) DrawCardsFor(p, 5);
   }
+  if (opening_chance_) DealOpeningHands();
 
   current_player_ = 0;
   actions_ = 1;
@@ -159,6 +401,11 @@ DominionState::DominionState(std::shared_ptr<const Game> game) : State(game) {
 
 DominionState::DominionState(std::shared_ptr<const Game> game, const json &j)
     : State(game) {
+  const auto &dgame = static_cast<const DominionGame &>(*game);
+  explicit_chance_ = dgame.ExplicitChance();
+  counts_deck_ = dgame.CountsDeck();
+  opening_chance_ = dgame.OpeningChance();
+  // Converted straight from the parsed tree; player entries are not re-dumped.
   DominionStateStructContents contents = j.get<DominionStateStructContents>();
   current_player_ = contents.current_player;
   coins_ = contents.coins;
@@ -172,41 +419,65 @@ DominionState::DominionState(std::shared_ptr<const Game> game, const json &j)
   shuffle_pending_end_of_turn_ = contents.shuffle_pending_end_of_turn;
   original_player_for_shuffle_ = contents.original_player_for_shuffle;
   pending_draw_count_after_shuffle_ = contents.pending_draw_count_after_shuffle;
+  pending_draws_ = contents.pending_draws;
   supply_piles_ = contents.supply_piles;
   initial_supply_piles_ = contents.initial_supply_piles;
   play_area_.clear();
   for (int v : contents.play_area) play_area_.push_back(static_cast<CardName>(v));
   for (int p = 0; p < kNumPlayers; ++p) {
     if (p < static_cast<int>(contents.player_states.size())) {
-      json pj = contents.player_states[p];
-      DominionPlayerStateStruct ss(pj.dump());
-      player_states_[p].LoadFromStruct(ss);
+      player_states_[p].LoadFromStruct(contents.player_states[p]);
+      if (!j.at("player_states")[p].contains("public_cards")) {
+        player_states_[p].RebuildPublicCards(p == current_player_ ? &play_area_
+                                                                  : nullptr);
+      }
     } else {
       // Leave as default-initialized; ensure obs_state is set.
-      player_states_[p].obs_state = std::make_unique<ObservationState>(player_states_[p].hand_counts_, player_states_[p].deck_, player_states_[p].discard_counts_);
+      player_states_[p].ResetObsState();
     }
   }
   history_.clear();
   move_number_ = contents.move_number;
 }
 
-Player DominionState::CurrentPlayer() const { return shuffle_pending_ ? kChancePlayerId : current_player_; }
+Player DominionState::CurrentPlayer() const {
+  if (shuffle_pending_ || DrawPlayer() != kInvalidPlayer) return kChancePlayerId;
+  return current_player_;
+}
 
 // Computes the legal actions for the current player.
 // Returns sorted IDs and delegates to pending-effect logic first.
 std::vector<Action> DominionState::LegalActions() const {
   std::vector<Action> actions;
+  LegalActions(&actions);
+  return actions;
+}
+
+void DominionState::LegalActions(std::vector<Action> *out) const {
+  DOMINION_PROBE_SCOPE(instrument::Probe::kLegalActions);
+  std::vector<Action> &actions = *out;
+  actions.clear();
   if (IsTerminal())
-    return actions;
+    return;
   if (IsChanceNode()) {
-    actions.push_back(ActionIds::Shuffle());
-    return actions;
+    if (explicit_chance_) {
+      int p = DrawPlayer();
+      int n = CountDrawOutcomes(player_states_[p].deck_counts_, DrawChunkSize(p));
+      actions.reserve(n);
+      for (int i = 0; i < n; ++i) actions.push_back(ActionIds::DrawOutcome(i));
+      return;
+    }
+    actions.reserve(kNumShuffleSeeds);
+    for (int i = 0; i < kNumShuffleSeeds; ++i) actions.push_back(ActionIds::ShuffleSeed(i));
+    return;
   }
   const auto &ps = player_states_[current_player_];
   {
     auto pend = PendingEffectLegalActions(*this, current_player_);
-    if (!pend.empty())
-      return pend;
+    if (!pend.empty()) {
+      actions.assign(pend.begin(), pend.end());
+      return;
+    }
   }
   if (phase_ == Phase::actionPhase) {
     if (actions_ > 0) {
@@ -220,20 +491,16 @@ std::vector<Action> DominionState::LegalActions() const {
     }
     actions.push_back(ActionIds::EndActions());
   } else if (phase_ == Phase::buyPhase) {
-    int effective_coins = coins_;
-    bool merchant_bonus_counted = false;
+    // Basic treasures in hand count as played; Merchants add their bonus once
+    // if a Silver is among them.
+    int effective_coins =
+        coins_ + count_kernels::DotPiles(ps.hand_counts_.data(), BasicTreasureValues().data());
+    if (merchants_played_ > 0 && ps.HandCount(CardName::CARD_Silver) > 0) {
+      effective_coins += merchants_played_;
+    }
     for (int j = 0; j < kNumSupplyPiles; ++j) {
       if (ps.hand_counts_[j] <= 0) continue;
-      const Card &spec = GetCardSpec(static_cast<CardName>(j));
-      if (HasType(spec, CardType::BASIC_TREASURE)) {
-        effective_coins += ps.hand_counts_[j] * spec.value_;
-        if (!merchant_bonus_counted && static_cast<CardName>(j) == CardName::CARD_Silver && merchants_played_ > 0) {
-          effective_coins += merchants_played_;
-          merchant_bonus_counted = true;
-        }
-        continue;
-      }
-      if (HasType(spec, CardType::SPECIAL_TREASURE)) {
+      if (HasType(GetCardSpec(static_cast<CardName>(j)), CardType::SPECIAL_TREASURE)) {
         actions.push_back(ActionIds::PlayHandIndex(j));
       }
     }
@@ -247,11 +514,23 @@ std::vector<Action> DominionState::LegalActions() const {
     actions.push_back(ActionIds::EndBuy());
   }
   std::sort(actions.begin(), actions.end());
-  return actions;
 }
 
 std::string DominionState::ActionToString(Player player,
                                           Action action_id) const {
+  std::array<int, kNumSupplyPiles> draw{};
+  if (player == kChancePlayerId && explicit_chance_ &&
+      DecodeDrawOutcome(action_id, &draw)) {
+    std::string s = "Draw_" + std::to_string(action_id - ActionIds::DrawOutcome(0)) + " (";
+    bool first = true;
+    for (int j = 0; j < kNumSupplyPiles; ++j) {
+      if (draw[j] == 0) continue;
+      if (!first) s += ", ";
+      s += GetCardSpec(static_cast<CardName>(j)).name_ + " x" + std::to_string(draw[j]);
+      first = false;
+    }
+    return s + ")";
+  }
   return ActionNames::NameWithCard(action_id, kNumSupplyPiles);
 }
 
@@ -269,6 +548,7 @@ std::unique_ptr<StateStruct> DominionState::ToStruct() const {
   contents.shuffle_pending_end_of_turn = shuffle_pending_end_of_turn_;
   contents.original_player_for_shuffle = original_player_for_shuffle_;
   contents.pending_draw_count_after_shuffle = pending_draw_count_after_shuffle_;
+  contents.pending_draws = pending_draws_;
   contents.supply_piles = supply_piles_;
   contents.initial_supply_piles = initial_supply_piles_;
   contents.play_area.clear();
@@ -277,23 +557,25 @@ std::unique_ptr<StateStruct> DominionState::ToStruct() const {
   contents.player_states.clear();
   contents.player_states.reserve(kNumPlayers);
   for (int p = 0; p < kNumPlayers; ++p) {
-    auto pstruct = player_states_[p].ToStruct();
-    nlohmann::json pj = pstruct->to_json_base();
-    contents.player_states.push_back(pj.get<DominionPlayerStructContents>());
+    contents.player_states.push_back(player_states_[p].ToContents());
   }
   contents.move_number = move_number_;
   auto ss = std::make_unique<DominionStateStruct>();
-  static_cast<DominionStateStructContents &>(*ss) = contents;
+  static_cast<DominionStateStructContents &>(*ss) = std::move(contents);
   return ss;
 }
 
-std::string DominionState::Serialize() const { return ToJson(); }
+std::string DominionState::Serialize() const {
+  DOMINION_PROBE_SCOPE(instrument::Probe::kSerializeJson);
+  return ToJson();
+}
 
 // Per-player observation string: only include public info and the player's own
 // privates.
 // TODO: Add information about deck and discard tracking, opponent deck
 // tracking, etc.
 std::string DominionState::ObservationString(int player) const {
+  DOMINION_TRACE_SPAN("ObservationString");
   const auto &ps_me = player_states_[player];
   const auto &ps_opp = player_states_[1 - player];
   auto card_name = [](CardName cn) { return GetCardSpec(cn).name_; };
@@ -317,20 +599,17 @@ std::string DominionState::ObservationString(int player) const {
     s += card_name(static_cast<CardName>(j)) + std::string("x") + std::to_string(cnt);
   }
   s += "\n";
-  s += std::string("DeckSize: ") + std::to_string(ps_me.deck_.size()) + "\n";
-  int discard_me_sz = 0; for (int j=0;j<kNumSupplyPiles;++j) discard_me_sz += ps_me.discard_counts_[j];
-  s += std::string("DiscardSize: ") + std::to_string(discard_me_sz) +
+  s += std::string("DeckSize: ") + std::to_string(ps_me.DeckSize()) + "\n";
+  s += std::string("DiscardSize: ") + std::to_string(ps_me.TotalDiscardSize()) +
        "\n";
 
   // Opponent privates are hidden; expose sizes only.
-  int opp_hand_size = 0; for (int j=0;j<kNumSupplyPiles;++j) opp_hand_size += ps_opp.hand_counts_[j];
-  s += std::string("OpponentHandSize: ") + std::to_string(opp_hand_size) +
+  s += std::string("OpponentHandSize: ") + std::to_string(ps_opp.TotalHandSize()) +
        "\n";
-  s += std::string("OpponentDeckSize: ") + std::to_string(ps_opp.deck_.size()) +
+  s += std::string("OpponentDeckSize: ") + std::to_string(ps_opp.DeckSize()) +
        "\n";
-  int discard_opp_sz = 0; for (int j=0;j<kNumSupplyPiles;++j) discard_opp_sz += ps_opp.discard_counts_[j];
   s += std::string("OpponentDiscardSize: ") +
-       std::to_string(discard_opp_sz) + "\n";
+       std::to_string(ps_opp.TotalDiscardSize()) + "\n";
 
   // Public supply counts.
   s += "Supply: ";
@@ -357,10 +636,9 @@ std::string DominionState::ObservationString(int player) const {
 
   // Append last public action and current legal actions (only for current
   // player).
-  const auto h = History();
-  if (!h.empty()) {
+  if (!history_.empty()) {
     s += "LastAction: ";
-    s += FormatActionPair(*this, h.back());
+    s += FormatLastAction(*this, history_.back());
     s += "\n";
   }
   if (player == current_player_) {
@@ -380,17 +658,176 @@ std::string DominionState::ObservationString(int player) const {
 // Information state string: perfect recall view for the player.
 // Include public info and the player's private info plus full public history.
 std::string DominionState::InformationStateString(int player) const {
+  DOMINION_TRACE_SPAN("InformationStateString");
   std::string s = ObservationString(player);
   // Include last action and legal actions for current player (already safe to
   // expose).
-  const auto h = History();
-  if (!h.empty()) {
+  if (!history_.empty()) {
     s += "\nLastAction: ";
-    s += FormatActionPair(*this, h.back());
+    s += FormatLastAction(*this, history_.back());
   }
   return s;
 }
 
+namespace {
+// Two-lane 64-bit mixer used to fold state fields into an InfosetKey.
+class InfosetKeyBuilder {
+ public:
+  void Add(uint64_t w) {
+    lo_ = Mix(lo_ ^ w);
+    hi_ = Mix(hi_ + w + 0x9E3779B97F4A7C15ULL);
+    ++words_;
+  }
+  // Packs small non-negative counts eight to a word.
+  template <size_t N>
+  void AddCounts(const std::array<int, N> &counts) {
+    uint64_t word = 0;
+    int shift = 0;
+    for (size_t j = 0; j < N; ++j) {
+      word |= static_cast<uint64_t>(static_cast<uint8_t>(counts[j])) << shift;
+      shift += 8;
+      if (shift == 64) {
+        Add(word);
+        word = 0;
+        shift = 0;
+      }
+    }
+    if (shift) Add(word);
+  }
+  InfosetKey Finish() {
+    Add(words_);
+    return InfosetKey{hi_, lo_};
+  }
+
+ private:
+  static uint64_t Mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+  uint64_t hi_ = 0x6A09E667F3BCC908ULL;
+  uint64_t lo_ = 0xBB67AE8584CAA73BULL;
+  uint64_t words_ = 0;
+};
+} // namespace
+
+void DominionState::ObservationBytes(int player, uint8_t *out) const {
+  DOMINION_TRACE_SPAN("ObservationBytes");
+  const auto &ps_me = player_states_[player];
+  const auto &ps_opp = player_states_[1 - player];
+  auto sat = [](int v) {
+    return static_cast<uint8_t>(v < 0 ? 0 : (v > 255 ? 255 : v));
+  };
+  int discard_me = ps_me.TotalDiscardSize();
+  int hand_opp = ps_opp.TotalHandSize();
+  int discard_opp = ps_opp.TotalDiscardSize();
+  uint8_t *o = out;
+  *o++ = static_cast<uint8_t>(player);
+  *o++ = static_cast<uint8_t>(phase_);
+  *o++ = sat(actions_);
+  *o++ = sat(buys_);
+  *o++ = sat(coins_);
+  *o++ = player == current_player_;
+  *o++ = sat(ps_me.DeckSize());
+  *o++ = sat(discard_me);
+  *o++ = sat(hand_opp);
+  *o++ = sat(ps_opp.DeckSize());
+  *o++ = sat(discard_opp);
+  for (int j = 0; j < kNumSupplyPiles; ++j) *o++ = sat(ps_me.hand_counts_[j]);
+  for (int j = 0; j < kNumSupplyPiles; ++j) *o++ = sat(ps_me.discard_counts_[j]);
+  for (int j = 0; j < kNumSupplyPiles; ++j) *o++ = sat(supply_piles_[j]);
+  uint8_t *play = o;
+  for (int j = 0; j < kNumSupplyPiles; ++j) *o++ = 0;
+  for (CardName cn : play_area_) {
+    uint8_t &c = play[static_cast<int>(cn)];
+    if (c < 255) c += 1;
+  }
+  for (int j = 0; j < kNumSupplyPiles; ++j) *o++ = sat(ps_opp.public_cards_.owned[j]);
+}
+
+InfosetKey DominionState::InformationStateKey(int player) const {
+  const auto &ps_me = player_states_[player];
+  const auto &ps_opp = player_states_[1 - player];
+
+  InfosetKeyBuilder b;
+  b.Add(static_cast<uint64_t>(player) |
+        static_cast<uint64_t>(CurrentPlayer() + 2) << 8 |
+        static_cast<uint64_t>(phase_) << 16 |
+        static_cast<uint64_t>(static_cast<uint8_t>(actions_)) << 24 |
+        static_cast<uint64_t>(static_cast<uint8_t>(buys_)) << 32 |
+        static_cast<uint64_t>(static_cast<uint16_t>(coins_)) << 40 |
+        static_cast<uint64_t>(static_cast<uint8_t>(merchants_played_)) << 56);
+  b.AddCounts(ps_me.hand_counts_);
+  b.Add(static_cast<uint64_t>(ps_me.DeckSize()) |
+        static_cast<uint64_t>(ps_me.TotalDiscardSize()) << 16 |
+        static_cast<uint64_t>(ps_opp.TotalHandSize()) << 32 |
+        static_cast<uint64_t>(ps_opp.DeckSize()) << 48);
+  b.Add(static_cast<uint64_t>(ps_opp.TotalDiscardSize()));
+  b.AddCounts(supply_piles_);
+
+  // Play area is public and ordered.
+  uint64_t word = play_area_.size();
+  int shift = 8;
+  for (CardName cn : play_area_) {
+    word |= static_cast<uint64_t>(static_cast<int>(cn)) << shift;
+    shift += 8;
+    if (shift == 64) {
+      b.Add(word);
+      word = 0;
+      shift = 0;
+    }
+  }
+  b.Add(word);
+
+  // Chance outcomes hash to one constant (see FormatLastAction).
+  if (history_.empty()) {
+    b.Add(~uint64_t{0});
+  } else if (history_.back().player == kChancePlayerId) {
+    b.Add(~uint64_t{1});
+  } else {
+    b.Add(static_cast<uint64_t>(history_.back().action));
+  }
+
+  // Own pending effect: fixes which selections remain legal.
+  b.Add(static_cast<uint64_t>(ps_me.pending_choice) |
+        static_cast<uint64_t>(ps_me.effect_queue.size()) << 8);
+  // The node's card is its JSON "kind"; fields are read in place rather than
+  // through EffectNodeToStruct.
+  if (const EffectNode *node = ps_me.FrontEffect()) {
+    const CardName card = node->card();
+    int throne_depth = 0;
+    if (card == CardName::CARD_ThroneRoom) {
+      throne_depth = static_cast<const ThroneRoomEffectNode *>(node)->throne_depth();
+    }
+    uint64_t fields = static_cast<uint64_t>(static_cast<uint8_t>(throne_depth)) << 8 |
+                      static_cast<uint64_t>(node->enforce_ascending) << 25;
+    if (const GainFromBoardStruct *gs = node->gain_from_board()) {
+      fields |= static_cast<uint64_t>(static_cast<uint8_t>(gs->max_cost)) << 16 |
+                static_cast<uint64_t>(gs->get_only_treasure()) << 24;
+    }
+    if (const HandSelectionStruct *hs = node->hand_selection()) {
+      fields |= static_cast<uint64_t>(hs->allow_finish_selection) << 26 |
+                static_cast<uint64_t>(hs->only_treasure) << 27 |
+                static_cast<uint64_t>(static_cast<uint8_t>(hs->target_hand_size)) << 32 |
+                static_cast<uint64_t>(static_cast<uint8_t>(hs->last_selected_original_index)) << 40 |
+                static_cast<uint64_t>(static_cast<uint8_t>(hs->selection_count)) << 48;
+    }
+    b.Add(static_cast<uint64_t>(card));
+    b.Add(fields);
+  }
+  // A Throne Room waiting behind its card's selection still owes plays.
+  if (ps_me.effect_queue.size() > 1) {
+    const EffectNode *back = ps_me.effect_queue.back().get();
+    if (back && back->card() == CardName::CARD_ThroneRoom) {
+      const auto *throne = static_cast<const ThroneRoomEffectNode *>(back);
+      b.Add(static_cast<uint64_t>(static_cast<uint8_t>(throne->throne_depth())) |
+            static_cast<uint64_t>(static_cast<uint8_t>(throne->doubling_pile())) << 8 |
+            static_cast<uint64_t>(static_cast<uint8_t>(throne->plays_left())) << 16);
+    }
+  }
+  return b.Finish();
+}
+
 std::string DominionState::ToString() const {
   return std::string("DominionState_Turn_") + std::to_string(turn_number_) +
          std::string("_Player_") + std::to_string(current_player_);
@@ -407,20 +844,20 @@ bool DominionState::IsTerminal() const {
 
 static int CountVP(const PlayerState &ps) {
   int vp = 0;
+  const auto deck_counts = ps.DeckCounts();
   auto count_all = [&](CardName name) {
     int idx = static_cast<int>(name);
     int in_hand = (idx >= 0 && idx < kNumSupplyPiles) ? ps.hand_counts_[idx] : 0;
     int in_discard = (idx >= 0 && idx < kNumSupplyPiles) ? ps.discard_counts_[idx] : 0;
-    return std::count(ps.deck_.begin(), ps.deck_.end(), name) + in_discard + in_hand;
+    int in_deck = (idx >= 0 && idx < kNumSupplyPiles) ? deck_counts[idx] : 0;
+    return in_deck + in_discard + in_hand;
   };
   int estates = count_all(CardName::CARD_Estate);
   int duchies = count_all(CardName::CARD_Duchy);
   int provinces = count_all(CardName::CARD_Province);
   int curses = count_all(CardName::CARD_Curse);
   int gardens = count_all(CardName::CARD_Gardens);
-  int total_cards = static_cast<int>(ps.deck_.size());
-  for (int j = 0; j < kNumSupplyPiles; ++j) total_cards += ps.discard_counts_[j];
-  for (int j = 0; j < kNumSupplyPiles; ++j) total_cards += ps.hand_counts_[j];
+  int total_cards = ps.DeckSize() + ps.TotalDiscardSize() + ps.TotalHandSize();
   vp += estates * 1 + duchies * 3 + provinces * 6;
   vp -= curses * 1;
   vp += gardens * (total_cards / 10);
@@ -442,43 +879,237 @@ std::vector<double> DominionState::Returns() const {
 }
 
 std::unique_ptr<State> DominionState::Clone() const {
+  DOMINION_PROBE_SCOPE(instrument::Probe::kClone);
   return std::unique_ptr<State>(new DominionState(*this));
 }
 
+void DominionState::CopyFrom(const DominionState &other) {
+  DOMINION_PROBE_SCOPE(instrument::Probe::kCopyFrom);
+  if (this == &other) return;
+  game_ = other.game_;
+  history_ = other.history_;
+  forced_moves_ = other.forced_moves_;
+  probe_move_ = other.probe_move_;
+  probes_ = other.probes_;
+  move_number_ = other.move_number_;
+  current_player_ = other.current_player_;
+  coins_ = other.coins_;
+  turn_number_ = other.turn_number_;
+  actions_ = other.actions_;
+  buys_ = other.buys_;
+  phase_ = other.phase_;
+  last_player_to_go_ = other.last_player_to_go_;
+  supply_piles_ = other.supply_piles_;
+  initial_supply_piles_ = other.initial_supply_piles_;
+  play_area_ = other.play_area_;
+  for (int p = 0; p < kNumPlayers; ++p) player_states_[p].AssignFrom(other.player_states_[p]);
+  merchants_played_ = other.merchants_played_;
+  explicit_chance_ = other.explicit_chance_;
+  counts_deck_ = other.counts_deck_;
+  opening_chance_ = other.opening_chance_;
+  pending_draws_ = other.pending_draws_;
+  shuffle_pending_ = other.shuffle_pending_;
+  shuffle_pending_end_of_turn_ = other.shuffle_pending_end_of_turn_;
+  original_player_for_shuffle_ = other.original_player_for_shuffle_;
+  pending_draw_count_after_shuffle_ = other.pending_draw_count_after_shuffle_;
+}
+
+void DominionState::ReplayHistory(const Action *actions, size_t n,
+                                  const std::vector<ForcedMove> &forced) {
+  const uint32_t start = static_cast<uint32_t>(history_.size());
+  replay_forced_ = &forced;
+  replay_next_ = std::lower_bound(forced.begin(), forced.end(), start,
+                                  [](const ForcedMove &f, uint32_t m) { return f.move < m; }) -
+                 forced.begin();
+  history_.reserve(history_.size() + n);
+  for (size_t i = 0; i < n; ++i) {
+    Player player = CurrentPlayer();
+    DoApplyAction(actions[i]);
+    history_.push_back({player, actions[i]});
+  }
+  replay_forced_ = nullptr;
+  move_number_ += static_cast<int>(n);
+}
+
+namespace {
+// Uniform index in [0, n) from a [0, 1) generator.
+inline int UniformIndex(const std::function<double()> &rng, int n) {
+  int r = static_cast<int>(rng() * n);
+  return r < n ? r : n - 1;
+}
+
+// Removes and returns one card drawn uniformly from a multiset of counts.
+inline int TakeFromCounts(std::array<int, kNumSupplyPiles> &counts, int total,
+                          const std::function<double()> &rng) {
+  int r = UniformIndex(rng, total);
+  for (int j = 0; j < kNumSupplyPiles; ++j) {
+    if (r < counts[j]) {
+      counts[j] -= 1;
+      return j;
+    }
+    r -= counts[j];
+  }
+  SpielFatalError("TakeFromCounts: counts do not sum to total");
+}
+
+// Fisher-Yates shuffle driven by a [0, 1) generator.
+inline void ShuffleDeck(std::vector<CardName> &deck,
+                        const std::function<double()> &rng) {
+  for (int i = static_cast<int>(deck.size()) - 1; i > 0; --i) {
+    std::swap(deck[i], deck[UniformIndex(rng, i + 1)]);
+  }
+}
+} // namespace
+
+std::unique_ptr<State> DominionState::ResampleFromInfostate(
+    int player_id, std::function<double()> rng) const {
+  auto out = std::unique_ptr<DominionState>(new DominionState(*this));
+  out->ResampleHiddenCards(player_id, rng);
+  return out;
+}
+
+void DominionState::ResampleHiddenCards(int player_id,
+                                        const std::function<double()> &rng) {
+  SPIEL_CHECK_TRUE(player_id >= 0 && player_id < kNumPlayers);
+  // A counts deck stores no order; redrawing its sampling seed is the
+  // equivalent of reshuffling. Known top cards stay in place.
+  auto reseed = [&rng](PlayerState &ps) {
+    ps.deck_rng_ = static_cast<uint64_t>(rng() * 4294967296.0) << 32 |
+                   static_cast<uint64_t>(rng() * 4294967296.0);
+  };
+  // Own deck contents are known; only the order is hidden.
+  if (counts_deck_) {
+    reseed(player_states_[player_id]);
+  } else {
+    ShuffleDeck(player_states_[player_id].deck_, rng);
+  }
+
+  // Opponent: everything not publicly located (the hand outside known_hand,
+  // the deck, and the discard outside known_discard) is one pool, dealt back
+  // at the observed hand, deck and discard sizes. The pool is the opponent's
+  // PublicCardTracker::Unlocated multiset, taken from the true piles so card
+  // totals are preserved exactly.
+  auto &opp = player_states_[1 - player_id];
+  const PublicCardTracker &known = opp.public_cards_;
+  // During a hand selection the cards it can still pick stay in hand so the
+  // effect node's legal moves survive: piles at or above the last pick when
+  // picks must ascend, the whole hand otherwise.
+  int reachable_from = kNumSupplyPiles;
+  if (opp.pending_choice != PendingChoice::None) {
+    const EffectNode *node = opp.FrontEffect();
+    const HandSelectionStruct *hs = node ? node->hand_selection() : nullptr;
+    if (hs) {
+      reachable_from = node->enforce_ascending
+                           ? std::max(0, hs->last_selected_original_index_value())
+                           : 0;
+    }
+  }
+  std::array<int, kNumSupplyPiles> pool{};
+  int hidden_hand = 0, hidden_discard = 0;
+  for (int j = 0; j < kNumSupplyPiles; ++j) {
+    int keep_hand = j >= reachable_from ? opp.hand_counts_[j]
+                                        : std::min(known.known_hand[j], opp.hand_counts_[j]);
+    int keep_discard = std::min(known.known_discard[j], opp.discard_counts_[j]);
+    pool[j] = opp.hand_counts_[j] - keep_hand + opp.discard_counts_[j] - keep_discard;
+    hidden_hand += opp.hand_counts_[j] - keep_hand;
+    hidden_discard += opp.discard_counts_[j] - keep_discard;
+    opp.hand_counts_[j] = keep_hand;
+    opp.discard_counts_[j] = keep_discard;
+  }
+  int total = hidden_hand + hidden_discard;
+  if (counts_deck_) {
+    total += count_kernels::SumPiles(opp.deck_counts_.data());
+    count_kernels::MovePiles(pool.data(), opp.deck_counts_.data());
+  } else {
+    for (CardName cn : opp.deck_) pool[static_cast<int>(cn)] += 1;
+    total += static_cast<int>(opp.deck_.size());
+  }
+  for (int i = 0; i < hidden_hand; ++i, --total) {
+    opp.hand_counts_[TakeFromCounts(pool, total, rng)] += 1;
+  }
+  for (int i = 0; i < hidden_discard; ++i, --total) {
+    opp.discard_counts_[TakeFromCounts(pool, total, rng)] += 1;
+  }
+  if (counts_deck_) {
+    opp.deck_counts_ = pool;
+  } else {
+    auto it = opp.deck_.begin();
+    for (int j = 0; j < kNumSupplyPiles; ++j) {
+      it = std::fill_n(it, pool[j], static_cast<CardName>(j));
+    }
+  }
+  if (counts_deck_) {
+    reseed(opp);
+  } else {
+    ShuffleDeck(opp.deck_, rng);
+  }
+}
+
 // Applies the given action_id for the current player.
 // - Delegates effect-specific resolution first (e.g., discard selection).
 // - Handles phase transitions: EndActions -> buyPhase; EndBuy -> cleanup + next
 // turn.
 void DominionState::DoApplyAction(Action action_id) {
+  DOMINION_PROBE_SCOPE(instrument::ApplyProbe(action_id));
+  DOMINION_TRACE_SPAN("ApplyAction", action_id);
+  if (IsChanceNode() && explicit_chance_) {
+    ApplyDrawOutcome(action_id);
+    if (!IsChanceNode()) {
+      MaybeResumeThroneRoom();
+      MaybeAutoAdvanceToBuyPhase();
+      MaybeAutoApplySingleAction();
+    }
+    return;
+  }
   if (IsChanceNode()) {
     SPIEL_CHECK_TRUE(shuffle_pending_);
-    SPIEL_CHECK_EQ(action_id, ActionIds::Shuffle());
-    // Localize RNG for shuffling discard into deck; reproducibility is not required.
-    unsigned seed = static_cast<unsigned>(std::random_device{}());
-    std::mt19937 local_rng(seed);
+    SPIEL_CHECK_GE(action_id, ActionIds::ShuffleSeed(0));
+    SPIEL_CHECK_LT(action_id, ActionIds::ShuffleSeed(kNumShuffleSeeds));
     auto &ps_orig = player_states_[original_player_for_shuffle_];
-    int discard_size = 0; for (int jj=0;jj<kNumSupplyPiles;++jj) discard_size += ps_orig.discard_counts_[jj];
-    if (discard_size > 0) {
-      std::vector<CardName> tmp;
-      tmp.reserve(discard_size);
-      for (int jj = 0; jj < kNumSupplyPiles; ++jj) {
-        for (int k = 0; k < ps_orig.discard_counts_[jj]; ++k) tmp.push_back(static_cast<CardName>(jj));
-        ps_orig.discard_counts_[jj] = 0;
+    const int discard_size = ps_orig.TotalDiscardSize();
+    // The permutation is a pure function of the seed outcome and public
+    // context, so replaying History() reproduces every shuffle.
+    uint64_t rng_state = static_cast<uint64_t>(action_id - ActionIds::ShuffleSeed(0));
+    rng_state ^= (static_cast<uint64_t>(original_player_for_shuffle_) << 16) ^
+                 (static_cast<uint64_t>(turn_number_) << 24) ^
+                 (static_cast<uint64_t>(discard_size) << 48);
+    {
+      DOMINION_PROBE_SCOPE(instrument::Probe::kShuffle);
+      DOMINION_TRACE_SPAN("Shuffle");
+      if (counts_deck_) {
+        // O(33) merge; the seed fixes the order draws will come out in.
+        count_kernels::MovePiles(ps_orig.deck_counts_.data(), ps_orig.discard_counts_.data());
+        ps_orig.deck_rng_ = SplitMix64(rng_state);
+      } else if (discard_size > 0) {
+        size_t base = ps_orig.deck_.size();
+        for (int jj = 0; jj < kNumSupplyPiles; ++jj) {
+          ps_orig.deck_.insert(ps_orig.deck_.end(), ps_orig.discard_counts_[jj], static_cast<CardName>(jj));
+          ps_orig.discard_counts_[jj] = 0;
+        }
+        // Fisher-Yates over the new cards; std::shuffle is implementation-defined.
+        for (int k = discard_size - 1; k > 0; --k) {
+          int r = ScaleToRange(SplitMix64(rng_state), k + 1);
+          std::swap(ps_orig.deck_[base + k], ps_orig.deck_[base + r]);
+        }
       }
-      std::shuffle(tmp.begin(), tmp.end(), local_rng);
-      ps_orig.deck_.insert(ps_orig.deck_.end(), tmp.begin(), tmp.end());
     }
+    ps_orig.public_cards_.OnReshuffle();
     shuffle_pending_ = false;
     Player resume_player = original_player_for_shuffle_;
     original_player_for_shuffle_ = -1;
     int to_draw = pending_draw_count_after_shuffle_;
     pending_draw_count_after_shuffle_ = 0;
     DrawCardsFor(resume_player, to_draw);
+    if (opening_chance_ && turn_number_ == 1 && play_area_.empty()) DealOpeningHands();
     if (shuffle_pending_end_of_turn_) {
       shuffle_pending_end_of_turn_ = false;
       current_player_ = 1 - resume_player;
       phase_ = Phase::actionPhase;
+    }
+    if (!IsChanceNode()) {
+      MaybeResumeThroneRoom();
       MaybeAutoAdvanceToBuyPhase();
+      MaybeAutoApplySingleAction();
     }
     return;
   }
@@ -487,9 +1118,14 @@ void DominionState::DoApplyAction(Action action_id) {
   // action handler, delegate to it first.
   if (!ps.effect_queue.empty() && ps.pending_choice != PendingChoice::None &&
       ps.effect_queue.front() && ps.effect_queue.front()->on_action) {
-    bool consumed =
-        ps.effect_queue.front()->on_action(*this, current_player_, action_id);
+    bool consumed;
+    {
+      DOMINION_PROBE_SCOPE(instrument::Probe::kEffectHandler);
+      DOMINION_TRACE_SPAN("EffectHandler", action_id);
+      consumed = ps.effect_queue.front()->on_action(*this, current_player_, action_id);
+    }
     if (consumed) {
+      MaybeResumeThroneRoom();
       MaybeAutoAdvanceToBuyPhase();
       MaybeAutoApplySingleAction();
       return;
@@ -510,6 +1146,7 @@ void DominionState::DoApplyAction(Action action_id) {
       if (HasType(spec, CardType::ACTION)) {
         play_area_.push_back(cn);
         ps.hand_counts_[j] -= 1;
+        ps.public_cards_.OnPlayFromHand(j);
         actions_ -= 1;
         spec.Play(*this, current_player_);
         if (cn == CardName::CARD_Merchant) {
@@ -534,6 +1171,7 @@ void DominionState::DoApplyAction(Action action_id) {
       if (HasType(spec, CardType::BASIC_TREASURE) || HasType(spec, CardType::SPECIAL_TREASURE)) {
         play_area_.push_back(cn);
         ps.hand_counts_[j] -= 1;
+        ps.public_cards_.OnPlayFromHand(j);
         spec.applyGrants(*this, current_player_);
         if (cn == CardName::CARD_Silver) {
           ApplyMerchantBonusOnSilverPlay();
@@ -553,7 +1191,7 @@ void DominionState::DoApplyAction(Action action_id) {
         if (!HasType(tspec, CardType::BASIC_TREASURE)) continue;
         int c = ps.hand_counts_[t];
         for (int k = 0; k < c; ++k) {
-          ApplyAction(ActionIds::PlayHandIndex(t));
+          DoApplyAction(ActionIds::PlayHandIndex(t));
         }
       }
       if (supply_piles_[j] > 0) {
@@ -562,6 +1200,7 @@ void DominionState::DoApplyAction(Action action_id) {
           coins_ -= spec.cost_;
           buys_ -= 1;
           ps.discard_counts_[j] += 1;
+          ps.public_cards_.OnGainToDiscard(j);
           supply_piles_[j] -= 1;
           if (buys_ == 0) {
             EndBuyCleanup();
@@ -579,23 +1218,20 @@ void DominionState::EndBuyCleanup() {
   // Cleanup end of turn for current_player_
   auto &ps = player_states_[current_player_];
   last_player_to_go_ = current_player_;
-  // Move all hand counts to discard.
-  for (int j = 0; j < kNumSupplyPiles; ++j) {
-    int cnt = ps.hand_counts_[j];
-    ps.discard_counts_[j] += cnt;
-    ps.hand_counts_[j] = 0;
-  }
+  ps.MoveHandToDiscard();
   for (auto c : play_area_) {
     int idx = static_cast<int>(c);
     if (idx >= 0 && idx < kNumSupplyPiles) ps.discard_counts_[idx] += 1;
   }
   play_area_.clear();
+  ps.public_cards_.OnCleanup();
 
   // Reset and switch the next player
   coins_ = 0;
   actions_ = 1;
   buys_ = 1;
   merchants_played_ = 0;
+  trace::TurnBoundary(turn_number_);
   turn_number_ += 1;
   DrawCardsFor(current_player_, 5);
   current_player_ = 1 - current_player_;
@@ -605,11 +1241,32 @@ void DominionState::EndBuyCleanup() {
   MaybeAutoAdvanceToBuyPhase();
 }
 
+// Opening-chance mode: deals each empty-handed player their first five cards,
+// stopping at the shuffle chance node that fixes the order.
+void DominionState::DealOpeningHands() {
+  for (int p = 0; p < kNumPlayers && !shuffle_pending_; ++p) {
+    auto &ps = player_states_[p];
+    if (ps.TotalHandSize() == 0 && ps.DeckSize() == 0) DrawCardsFor(p, 5);
+  }
+}
+
+void DominionState::MaybeResumeThroneRoom() {
+  if (IsChanceNode()) return;
+  auto &ps = player_states_[current_player_];
+  if (ps.pending_choice != PendingChoice::None) return;
+  EffectNode *node = ps.FrontEffect();
+  if (!node || node->card() != CardName::CARD_ThroneRoom) return;
+  auto *throne = static_cast<ThroneRoomEffectNode *>(node);
+  if (throne->doubling_pile() >= 0) throne->PlayDoubled(*this, current_player_);
+}
+
 void DominionState::MaybeAutoAdvanceToBuyPhase() {
   // Only consider auto-advancing when in action phase and not in the middle of
   // resolving an effect/choice.
   auto &ps = player_states_[current_player_];
   if (phase_ != Phase::actionPhase) return;
+  // The hand is incomplete until pending draws or shuffles resolve.
+  if (IsChanceNode()) return;
   if (!ps.effect_queue.empty() || ps.pending_choice != PendingChoice::None) return;
 
   // If the player has zero actions, or has no action cards in hand, switch.
@@ -633,12 +1290,31 @@ void DominionState::MaybeAutoApplySingleAction() {
   // Preserve interactive flows for action selection (e.g., Throne Room).
   const auto &ps = player_states_[current_player_];
   if (ps.pending_choice == PendingChoice::PlayActionFromHand) return;
+  const uint32_t move = static_cast<uint32_t>(history_.size());
+  if (move != probe_move_) {
+    probe_move_ = move;
+    probes_ = 0;
+  }
   // Limit iteration to prevent pathological loops.
   int guard = 0;
   while (!IsTerminal() && !IsChanceNode()) {
-    auto las = LegalActions();
-    if (las.size() != 1) break;
-    ApplyAction(las[0]);
+    const uint32_t probe = probes_++;
+    Action forced;
+    if (replay_forced_ != nullptr) {
+      // Replaying a recorded game: the record says whether this check found
+      // a single legal action.
+      if (replay_next_ == replay_forced_->size()) break;
+      const ForcedMove &next = (*replay_forced_)[replay_next_];
+      if (next.move != move || next.probe != probe) break;
+      forced = next.action;
+      replay_next_ += 1;
+    } else {
+      auto las = LegalActions();
+      if (las.size() != 1) break;
+      forced = las[0];
+    }
+    forced_moves_.push_back({move, probe, forced});
+    DoApplyAction(forced);
     guard += 1;
     if (guard > kDominionMaxDistinctActions) break;
   }
@@ -652,7 +1328,24 @@ void DominionState::ApplyMerchantBonusOnSilverPlay() {
 }
 
 ActionsAndProbs DominionState::ChanceOutcomes() const {
-  return ActionsAndProbs{{ActionIds::Shuffle(), 1.0}};
+  if (explicit_chance_) {
+    int p = DrawPlayer();
+    SPIEL_CHECK_NE(p, kInvalidPlayer);
+    ActionsAndProbs outcomes;
+    int i = 0;
+    ForEachDraw(player_states_[p].deck_counts_, DrawChunkSize(p),
+                [&](const std::array<int, kNumSupplyPiles> &, double prob) {
+                  outcomes.push_back({ActionIds::DrawOutcome(i++), prob});
+                  return true;
+                });
+    return outcomes;
+  }
+  ActionsAndProbs outcomes;
+  outcomes.reserve(kNumShuffleSeeds);
+  for (int i = 0; i < kNumShuffleSeeds; ++i) {
+    outcomes.push_back({ActionIds::ShuffleSeed(i), 1.0 / kNumShuffleSeeds});
+  }
+  return outcomes;
 }
 
 } // namespace dominion
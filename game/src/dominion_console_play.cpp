@@ -1,12 +1,25 @@
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_bots.h"
 #include "open_spiel/tests/console_play_test.h"
+#include "heuristic_bots.hpp"
+#include <iostream>
 #include <unordered_map>
 
-int main() {
+// usage: dominion_console_play [opponent]
+// opponent: random (default), bigmoney, bm_smithy, bm_militia, bm_witch, chapel
+int main(int argc, char **argv) {
   auto game = open_spiel::LoadGame("dominion");
   std::unordered_map<open_spiel::Player, std::unique_ptr<open_spiel::Bot>> bots;
-  bots[1] = open_spiel::MakeUniformRandomBot(1, 12345);
+  std::string opponent = argc > 1 ? argv[1] : "random";
+  open_spiel::dominion::HeuristicStrategy strategy;
+  if (opponent == "random") {
+    bots[1] = open_spiel::MakeUniformRandomBot(1, 12345);
+  } else if (open_spiel::dominion::ParseHeuristicStrategy(opponent, &strategy)) {
+    bots[1] = open_spiel::dominion::MakeHeuristicBot(strategy);
+  } else {
+    std::cerr << "unknown opponent: " << opponent << "\n";
+    return 2;
+  }
   open_spiel::testing::ConsolePlayTest(*game, nullptr, nullptr, &bots);
   return 0;
 }
@@ -0,0 +1,151 @@
+// Native self-play driver: plays many games concurrently with per-seat bots
+// and streams one JSON line per finished game and, optionally, trajectories.
+//
+//   dominion_selfplay --games=100000 --threads=64 --seats=bigmoney,random
+//                     [--seed=N] [--kingdom=Smithy,Militia,...] [--counts_deck]
+//                     [--max_moves=N] [--results=games.jsonl]
+//                     [--trajectories=games.dt] [--trace=trace.json]
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "open_spiel/json/include/nlohmann/json.hpp"
+#include "open_spiel/spiel.h"
+
+#include "dominion.hpp"
+#include "selfplay.hpp"
+#include "trace.hpp"
+#include "trajectory.hpp"
+
+namespace {
+
+using open_spiel::dominion::BotFactory;
+using open_spiel::dominion::SelfPlayGame;
+
+std::vector<std::string> SplitCommas(const std::string &s) {
+  std::vector<std::string> out;
+  size_t start = 0;
+  while (start <= s.size()) {
+    size_t end = s.find(',', start);
+    if (end == std::string::npos) end = s.size();
+    out.push_back(s.substr(start, end - start));
+    start = end + 1;
+  }
+  return out;
+}
+
+int Usage(const char *argv0) {
+  std::cerr << "usage: " << argv0
+            << " [--games=n] [--threads=n] [--seed=n] [--seats=policy,policy]"
+               " [--kingdom=cards] [--counts_deck] [--max_moves=n]"
+               " [--results=path] [--trajectories=path] [--trace=path]\n"
+               "policies: random, bigmoney, bm_smithy, bm_militia, bm_witch, chapel, mcts\n";
+  return 2;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  namespace dom = open_spiel::dominion;
+  dom::SelfPlayConfig config;
+  std::string seats_flag = "random,random", kingdom, results_path, trajectories_path,
+              trace_path;
+  bool counts_deck = false;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    auto value = [&](const char *prefix) -> const char * {
+      size_t n = std::string(prefix).size();
+      return arg.compare(0, n, prefix) == 0 ? argv[i] + n : nullptr;
+    };
+    if (const char *v = value("--games=")) {
+      config.num_games = std::atoi(v);
+    } else if (const char *v = value("--threads=")) {
+      config.num_threads = std::atoi(v);
+    } else if (const char *v = value("--seed=")) {
+      config.seed = std::strtoull(v, nullptr, 10);
+    } else if (const char *v = value("--seats=")) {
+      seats_flag = v;
+    } else if (const char *v = value("--kingdom=")) {
+      kingdom = v;
+    } else if (arg == "--counts_deck") {
+      counts_deck = true;
+    } else if (const char *v = value("--max_moves=")) {
+      config.max_moves = std::atoi(v);
+    } else if (const char *v = value("--results=")) {
+      results_path = v;
+    } else if (const char *v = value("--trajectories=")) {
+      trajectories_path = v;
+    } else if (const char *v = value("--trace=")) {
+      trace_path = v;
+    } else {
+      return Usage(argv[0]);
+    }
+  }
+  std::vector<std::string> seat_names = SplitCommas(seats_flag);
+  if (static_cast<int>(seat_names.size()) != dom::kNumPlayers) return Usage(argv[0]);
+  std::vector<BotFactory> seats;
+  for (const std::string &name : seat_names) seats.push_back(dom::MakeBotFactory(name));
+
+  // The opening deal is a chance node, so each game is fixed by its seed.
+  open_spiel::GameParameters params = {
+      {"opening_chance", open_spiel::GameParameter(true)},
+      {"counts_deck", open_spiel::GameParameter(counts_deck)}};
+  if (!kingdom.empty()) params["kingdom"] = open_spiel::GameParameter(kingdom);
+  std::shared_ptr<const open_spiel::Game> game = open_spiel::LoadGame("dominion", params);
+  const auto &dgame = static_cast<const dom::DominionGame &>(*game);
+
+  std::ofstream results;
+  if (!results_path.empty()) {
+    results.open(results_path, std::ios::out | std::ios::trunc);
+    if (!results) {
+      std::cerr << "cannot write " << results_path << "\n";
+      return 1;
+    }
+  }
+  std::unique_ptr<dom::TrajectoryWriter> trajectories;
+  if (!trajectories_path.empty()) {
+    trajectories = std::make_unique<dom::TrajectoryWriter>(trajectories_path);
+  }
+  config.record_actions = trajectories != nullptr;
+  if (!trace_path.empty()) open_spiel::dominion::trace::Enable();
+
+  dom::GameSink sink;
+  if (results.is_open() || trajectories) {
+    sink = [&](const SelfPlayGame &g) {
+      if (results.is_open()) {
+        nlohmann::json line = {{"game", g.index},   {"seed", g.seed},
+                               {"worker", g.worker}, {"moves", g.moves},
+                               {"capped", g.capped}, {"returns", g.returns}};
+        results << line.dump() << '\n';
+      }
+      if (trajectories) {
+        trajectories->BeginGame(static_cast<const dom::DominionState &>(*g.initial));
+        for (open_spiel::Action a : g.actions) trajectories->AddStep(a);
+        trajectories->EndGame(g.returns);
+      }
+    };
+  }
+
+  dom::SelfPlayStats stats = dom::RunSelfPlay(dgame, config, seats, sink);
+  if (trajectories) trajectories->Flush();
+  if (!trace_path.empty() && !open_spiel::dominion::trace::WriteChromeTrace(trace_path)) {
+    std::cerr << "cannot write " << trace_path << "\n";
+    return 1;
+  }
+
+  std::printf("games %d (capped %d) on %d threads in %.2fs: %.0f games/s, %.0f moves/s, "
+              "%lld steals\n",
+              stats.games, stats.capped, stats.threads, stats.seconds,
+              stats.games / stats.seconds, stats.moves / stats.seconds,
+              static_cast<long long>(stats.steals));
+  for (int p = 0; p < dom::kNumPlayers; ++p) {
+    std::printf("seat %d (%s): mean return %+.3f\n", p, seat_names[p].c_str(),
+                stats.games ? stats.total_returns[p] / stats.games : 0.0);
+  }
+  return 0;
+}
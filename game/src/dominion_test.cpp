@@ -1,11 +1,31 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
 #include <memory>
+#include <random>
 
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
 
 #include "dominion.hpp"
 #include "actions.hpp"
+#include "alloc_counter.hpp"
+#include "batch_env.hpp"
+#include "count_batch.hpp"
+#include "count_kernels.hpp"
 #include "effects.hpp"
+#include "heuristic_bots.hpp"
+#include "histogram.hpp"
+#include "instrument.hpp"
+#include "mcts.hpp"
+#include "replay.hpp"
+#include "replay_store.hpp"
+#include "selfplay.hpp"
+#include "trace.hpp"
+#include "trajectory.hpp"
 
 using open_spiel::LoadGame;
 using open_spiel::State;
@@ -22,7 +42,7 @@ struct DominionTestHarness {
   static CardName SupplyType(DominionState* s, int idx) {
     (void)s; return static_cast<CardName>(idx);
   }
-  static int DeckSize(DominionState* s, int player) { return static_cast<int>(s->player_states_[player].deck_.size()); }
+  static int DeckSize(DominionState* s, int player) { return s->player_states_[player].DeckSize(); }
   static int HandSize(DominionState* s, int player) {
     int cnt = 0; for (int j=0;j<kNumSupplyPiles;++j) cnt += s->player_states_[player].hand_counts_[j];
     return cnt;
@@ -59,6 +79,9 @@ struct DominionTestHarness {
   static void SetProvinceEmpty(DominionState* s) {
     s->supply_piles_[5] = 0; // Province index
   }
+  static open_spiel::dominion::PublicCardTracker& PublicCards(DominionState* s, int player) {
+    return s->player_states_[player].public_cards_;
+  }
   // Returns a copy of the current hand for verification.
   static std::array<int, kNumSupplyPiles> Hand(DominionState* s, int player) {
     return s->player_states_[player].hand_counts_;
@@ -81,9 +104,34 @@ static void TestAutoEndOnLastBuy();
 static void TestAutoAdvanceOnZeroActions();
 static void TestDominionStateJsonRoundTrip();
 static void TestDominionStateSerializeDeserialize();
+static void TestLegacyJsonLoads();
 static void TestEffectQueueJsonRoundTrip();
 static void TestThroneRoomChainJsonRoundTrip();
 static void TestEffectQueueSerializeDeserialize();
+static void TestInformationStateKey();
+static void TestResampleFromInfostate();
+static void TestPublicCardTracker();
+static void TestExplicitChanceDraws();
+static void TestCountsDeck();
+static void TestShuffleSeedReplay();
+static void TestKeyframedReplay();
+static void TestBinarySerialization();
+static void TestTrajectoryRoundTrip();
+static void TestReplayStore();
+static void TestKingdomParameter();
+static void TestInstrumentation();
+static void TestAllocationBudgets();
+static void TestTrace();
+static void TestLatencyHistogram();
+static void TestSelfPlay();
+static void TestBatchEnv();
+static void TestCountBatch();
+static void TestCountKernels();
+static void TestHeuristicBots();
+static void TestMcts();
+static void TestParallelMcts();
+static void TestShuffleSeedHidden();
+static void TestResampleHiddenSplit();
 
 // Gardens: 1 VP per Gardens for every 10 total cards (deck+discard+hand).
 static void TestGardensVP() {
@@ -304,9 +352,34 @@ int main() {
   TestBuyFromSupplyAutoPlaysBasicTreasures();
   TestDominionStateJsonRoundTrip();
   TestDominionStateSerializeDeserialize();
+  TestLegacyJsonLoads();
   TestEffectQueueJsonRoundTrip();
   TestThroneRoomChainJsonRoundTrip();
   TestEffectQueueSerializeDeserialize();
+  TestInformationStateKey();
+  TestResampleFromInfostate();
+  TestPublicCardTracker();
+  TestExplicitChanceDraws();
+  TestCountsDeck();
+  TestShuffleSeedReplay();
+  TestKeyframedReplay();
+  TestBinarySerialization();
+  TestTrajectoryRoundTrip();
+  TestReplayStore();
+  TestKingdomParameter();
+  TestInstrumentation();
+  TestAllocationBudgets();
+  TestTrace();
+  TestLatencyHistogram();
+  TestSelfPlay();
+  TestBatchEnv();
+  TestCountBatch();
+  TestCountKernels();
+  TestHeuristicBots();
+  TestMcts();
+  TestParallelMcts();
+  TestShuffleSeedHidden();
+  TestResampleHiddenSplit();
   return 0;
 }
 // Playing an action that consumes the last action should auto-advance to buy phase.
@@ -387,6 +460,13 @@ static void TestDominionStateJsonRoundTrip() {
   SPIEL_CHECK_EQ(DominionTestHarness::Actions(ds), DominionTestHarness::Actions(ds_copy));
   SPIEL_CHECK_EQ(DominionTestHarness::Buys(ds), DominionTestHarness::Buys(ds_copy));
   SPIEL_CHECK_EQ(DominionTestHarness::Coins(ds), DominionTestHarness::Coins(ds_copy));
+  SPIEL_CHECK_EQ(ds_copy->ToJson(), json_str);
+
+  // Player entries load directly from their subtree.
+  open_spiel::dominion::PlayerState ps(j["player_states"][1]);
+  SPIEL_CHECK_TRUE(ps.hand_counts_ == ds->player_states_[1].hand_counts_);
+  SPIEL_CHECK_TRUE(ps.deck_ == ds->player_states_[1].deck_);
+  SPIEL_CHECK_EQ(nlohmann::json(ps.ToContents()), j["player_states"][1]);
 }
 
 // Verify that Serialize and DeserializeState round-trip equivalently.
@@ -487,3 +567,1241 @@ static void TestEffectQueueSerializeDeserialize() {
   SPIEL_CHECK_EQ(EffectQueueSize(ds_copy, 0), 1);
   SPIEL_CHECK_EQ(PendingChoiceVal(ds_copy, 0), static_cast<int>(open_spiel::dominion::PendingChoice::SelectUpToCardsFromBoard));
 }
+
+// InformationStateKey ignores hidden opponent state and tracks visible changes.
+static void TestInformationStateKey() {
+  std::shared_ptr<const Game> game = LoadGame("dominion");
+  std::unique_ptr<State> state = game->NewInitialState();
+  auto* ds = dynamic_cast<DominionState*>(state.get());
+  SPIEL_CHECK_TRUE(ds != nullptr);
+
+  std::unique_ptr<State> clone = ds->Clone();
+  auto* dc = dynamic_cast<DominionState*>(clone.get());
+  SPIEL_CHECK_TRUE(ds->InformationStateKey(0) == dc->InformationStateKey(0));
+  SPIEL_CHECK_TRUE(ds->InformationStateKey(0) != ds->InformationStateKey(1));
+
+  // Swap opponent's hidden hand/deck composition at equal sizes: player 0 cannot
+  // tell the difference, player 1 can.
+  auto& opp = dc->player_states_[1];
+  DominionTestHarness::ResetPlayer(dc, 1);
+  for (int i = 0; i < 5; ++i) DominionTestHarness::AddCardToHand(dc, 1, CardName::CARD_Estate);
+  for (int i = 0; i < 5; ++i) DominionTestHarness::AddCardToDeck(dc, 1, CardName::CARD_Gold);
+  SPIEL_CHECK_EQ(static_cast<int>(opp.deck_.size()), DominionTestHarness::DeckSize(ds, 1));
+  SPIEL_CHECK_EQ(ds->InformationStateString(0), dc->InformationStateString(0));
+  SPIEL_CHECK_TRUE(ds->InformationStateKey(0) == dc->InformationStateKey(0));
+  SPIEL_CHECK_TRUE(ds->InformationStateKey(1) != dc->InformationStateKey(1));
+
+  // A visible change to the player's own hand changes the key.
+  DominionTestHarness::AddCardToHand(dc, 0, CardName::CARD_Silver);
+  SPIEL_CHECK_TRUE(ds->InformationStateKey(0) != dc->InformationStateKey(0));
+
+  // Applying an action changes the key for both players.
+  auto before0 = ds->InformationStateKey(0);
+  auto before1 = ds->InformationStateKey(1);
+  ds->ApplyAction(open_spiel::dominion::ActionIds::EndBuy());
+  SPIEL_CHECK_TRUE(ds->InformationStateKey(0) != before0);
+  SPIEL_CHECK_TRUE(ds->InformationStateKey(1) != before1);
+}
+
+// Resampling keeps everything player 0 knows and preserves card totals.
+static void TestResampleFromInfostate() {
+  std::shared_ptr<const Game> game = LoadGame("dominion");
+  std::unique_ptr<State> state = game->NewInitialState();
+  auto* ds = dynamic_cast<DominionState*>(state.get());
+  SPIEL_CHECK_TRUE(ds != nullptr);
+  // Give player 1 a mixed hidden pool so resampling has something to move.
+  DominionTestHarness::AddCardToDeck(ds, 1, CardName::CARD_Gold);
+  DominionTestHarness::AddCardToDeck(ds, 1, CardName::CARD_Province);
+
+  auto totals = [](DominionState* s, int p) {
+    std::array<int, kNumSupplyPiles> t = DominionTestHarness::Hand(s, p);
+    for (CardName cn : s->player_states_[p].deck_) t[static_cast<int>(cn)] += 1;
+    return t;
+  };
+
+  std::mt19937 gen(7);
+  std::uniform_real_distribution<double> dist(0.0, 1.0);
+  std::function<double()> rng = [&]() { return dist(gen); };
+  bool opp_hand_changed = false;
+  for (int i = 0; i < 50; ++i) {
+    std::unique_ptr<State> sample = ds->ResampleFromInfostate(0, rng);
+    auto* rs = dynamic_cast<DominionState*>(sample.get());
+    SPIEL_CHECK_TRUE(rs != nullptr);
+    SPIEL_CHECK_TRUE(rs->InformationStateKey(0) == ds->InformationStateKey(0));
+    SPIEL_CHECK_TRUE(DominionTestHarness::Hand(rs, 0) == DominionTestHarness::Hand(ds, 0));
+    SPIEL_CHECK_TRUE(totals(rs, 0) == totals(ds, 0));
+    SPIEL_CHECK_TRUE(totals(rs, 1) == totals(ds, 1));
+    SPIEL_CHECK_EQ(DominionTestHarness::HandSize(rs, 1), DominionTestHarness::HandSize(ds, 1));
+    SPIEL_CHECK_EQ(DominionTestHarness::DeckSize(rs, 1), DominionTestHarness::DeckSize(ds, 1));
+    if (DominionTestHarness::Hand(rs, 1) != DominionTestHarness::Hand(ds, 1)) opp_hand_changed = true;
+  }
+  SPIEL_CHECK_TRUE(opp_hand_changed);
+}
+
+static void TestPublicCardTracker() {
+  std::shared_ptr<const Game> game = LoadGame("dominion");
+  std::unique_ptr<State> state = game->NewInitialState();
+  auto* ds = dynamic_cast<DominionState*>(state.get());
+  SPIEL_CHECK_TRUE(ds != nullptr);
+  const int copper = static_cast<int>(CardName::CARD_Copper);
+  const int estate = static_cast<int>(CardName::CARD_Estate);
+  const int silver = static_cast<int>(CardName::CARD_Silver);
+  const int gold = static_cast<int>(CardName::CARD_Gold);
+  for (int p = 0; p < kNumPlayers; ++p) {
+    const auto& pc = ds->PublicCards(p);
+    SPIEL_CHECK_EQ(pc.owned[copper], 7);
+    SPIEL_CHECK_EQ(pc.owned[estate], 3);
+    SPIEL_CHECK_EQ(pc.Unlocated(copper) + pc.Unlocated(estate), 10);
+  }
+
+  // Buying with three Coppers: the played Coppers and the gained Silver are
+  // provably in the discard after cleanup; the rest of the hand is not.
+  DominionTestHarness::ResetPlayer(ds, 0);
+  for (int i = 0; i < 3; ++i) DominionTestHarness::AddCardToHand(ds, 0, CardName::CARD_Copper);
+  DominionTestHarness::AddCardToHand(ds, 0, CardName::CARD_Estate);
+  for (int i = 0; i < 5; ++i) DominionTestHarness::AddCardToDeck(ds, 0, CardName::CARD_Copper);
+  ds->phase_ = Phase::buyPhase;
+  ds->ApplyAction(open_spiel::dominion::ActionIds::BuyBase() + silver);
+  {
+    const auto& pc = ds->PublicCards(0);
+    SPIEL_CHECK_EQ(pc.owned[silver], 1);
+    SPIEL_CHECK_EQ(pc.known_discard[silver], 1);
+    SPIEL_CHECK_EQ(pc.known_discard[copper], 3);
+    SPIEL_CHECK_EQ(pc.known_discard[estate], 0);
+    for (int j = 0; j < kNumSupplyPiles; ++j) {
+      SPIEL_CHECK_EQ(pc.in_play[j], 0);
+      SPIEL_CHECK_EQ(pc.known_hand[j], 0);
+    }
+  }
+
+  // Tracker survives Clone and JSON round trip.
+  std::unique_ptr<State> clone = ds->Clone();
+  auto* dc = dynamic_cast<DominionState*>(clone.get());
+  SPIEL_CHECK_TRUE(dc->PublicCards(0).known_discard == ds->PublicCards(0).known_discard);
+  std::unique_ptr<State> loaded = game->NewInitialState(nlohmann::json::parse(ds->ToJson()));
+  auto* dl = dynamic_cast<DominionState*>(loaded.get());
+  SPIEL_CHECK_TRUE(dl->PublicCards(0).owned == ds->PublicCards(0).owned);
+  SPIEL_CHECK_TRUE(dl->PublicCards(0).known_discard == ds->PublicCards(0).known_discard);
+
+  // A card known to be in the opponent's hand stays there under resampling.
+  DominionTestHarness::AddCardToHand(ds, 1, CardName::CARD_Gold);
+  auto& pc1 = DominionTestHarness::PublicCards(ds, 1);
+  pc1.owned[gold] += 1;
+  pc1.known_hand[gold] += 1;
+  std::mt19937 gen(11);
+  std::uniform_real_distribution<double> dist(0.0, 1.0);
+  std::function<double()> rng = [&]() { return dist(gen); };
+  for (int i = 0; i < 20; ++i) {
+    std::unique_ptr<State> sample = ds->ResampleFromInfostate(0, rng);
+    auto* rs = dynamic_cast<DominionState*>(sample.get());
+    SPIEL_CHECK_EQ(DominionTestHarness::Hand(rs, 1)[gold], 1);
+  }
+}
+
+static void TestExplicitChanceDraws() {
+  std::shared_ptr<const Game> game =
+      LoadGame("dominion", {{"explicit_chance", open_spiel::GameParameter(true)}});
+  SPIEL_CHECK_TRUE(game->GetType().chance_mode ==
+                   open_spiel::GameType::ChanceMode::kExplicitStochastic);
+  std::unique_ptr<State> state = game->NewInitialState();
+  auto* ds = dynamic_cast<DominionState*>(state.get());
+  SPIEL_CHECK_TRUE(ds != nullptr);
+
+  // Opening deal: 5 of 7 Copper + 3 Estate has four distinct outcomes with
+  // hypergeometric weights 21, 105, 105, 21 out of C(10, 5) = 252.
+  SPIEL_CHECK_TRUE(ds->IsChanceNode());
+  auto outcomes = ds->ChanceOutcomes();
+  SPIEL_CHECK_EQ(outcomes.size(), 4);
+  const double expected[] = {21.0 / 252, 105.0 / 252, 105.0 / 252, 21.0 / 252};
+  for (int i = 0; i < 4; ++i) {
+    SPIEL_CHECK_EQ(outcomes[i].first, open_spiel::dominion::ActionIds::DrawOutcome(i));
+    SPIEL_CHECK_FLOAT_NEAR(outcomes[i].second, expected[i], 1e-12);
+  }
+  SPIEL_CHECK_TRUE(ds->LegalActions().size() == outcomes.size());
+  // Outcome 1 is four Coppers and one Estate for player 0.
+  ds->ApplyAction(outcomes[1].first);
+  const int copper = static_cast<int>(CardName::CARD_Copper);
+  const int estate = static_cast<int>(CardName::CARD_Estate);
+  SPIEL_CHECK_EQ(DominionTestHarness::Hand(ds, 0)[copper], 4);
+  SPIEL_CHECK_EQ(DominionTestHarness::Hand(ds, 0)[estate], 1);
+  SPIEL_CHECK_EQ(DominionTestHarness::DeckSize(ds, 0), 5);
+  SPIEL_CHECK_TRUE(ds->IsChanceNode());  // player 1's deal
+
+  // The pending draw survives a JSON round trip.
+  std::unique_ptr<State> loaded = game->NewInitialState(nlohmann::json::parse(ds->ToJson()));
+  SPIEL_CHECK_TRUE(loaded->IsChanceNode());
+  SPIEL_CHECK_TRUE(loaded->ChanceOutcomes() == ds->ChanceOutcomes());
+
+  // Random playout sampling chance by the reported probabilities; every chance
+  // node must be a proper distribution within MaxChanceOutcomes.
+  std::mt19937 gen(3);
+  std::uniform_real_distribution<double> u(0.0, 1.0);
+  int chance_nodes = 0;
+  for (int steps = 0; steps < 2000 && !state->IsTerminal(); ++steps) {
+    if (state->IsChanceNode()) {
+      auto co = state->ChanceOutcomes();
+      SPIEL_CHECK_FALSE(co.empty());
+      SPIEL_CHECK_LE(static_cast<int>(co.size()), game->MaxChanceOutcomes());
+      double total = 0.0;
+      for (const auto& o : co) total += o.second;
+      SPIEL_CHECK_FLOAT_NEAR(total, 1.0, 1e-9);
+      double r = u(gen);
+      size_t k = 0;
+      while (k + 1 < co.size() && r >= co[k].second) { r -= co[k].second; ++k; }
+      state->ApplyAction(co[k].first);
+      ++chance_nodes;
+    } else {
+      auto la = state->LegalActions();
+      std::uniform_int_distribution<size_t> pick(0, la.size() - 1);
+      state->ApplyAction(la[pick(gen)]);
+    }
+  }
+  SPIEL_CHECK_GT(chance_nodes, 10);
+}
+
+static void TestCountsDeck() {
+  std::shared_ptr<const Game> game =
+      LoadGame("dominion", {{"counts_deck", open_spiel::GameParameter(true)}});
+  std::unique_ptr<State> state = game->NewInitialState();
+  auto* ds = dynamic_cast<DominionState*>(state.get());
+  SPIEL_CHECK_TRUE(ds != nullptr);
+  SPIEL_CHECK_TRUE(ds->CountsDeck());
+  SPIEL_CHECK_FALSE(ds->IsChanceNode());
+  for (int p = 0; p < kNumPlayers; ++p) {
+    const auto& ps = ds->player_states_[p];
+    SPIEL_CHECK_TRUE(ps.deck_.empty());
+    SPIEL_CHECK_EQ(DominionTestHarness::HandSize(ds, p), 5);
+    SPIEL_CHECK_EQ(ps.DeckSize(), 5);
+    auto all = ps.DeckCounts();
+    for (int j = 0; j < kNumSupplyPiles; ++j) all[j] += ps.hand_counts_[j];
+    SPIEL_CHECK_EQ(all[static_cast<int>(CardName::CARD_Copper)], 7);
+    SPIEL_CHECK_EQ(all[static_cast<int>(CardName::CARD_Estate)], 3);
+  }
+
+  // Draws are determined by the stored seed: a JSON copy fed the same actions
+  // draws the same hands until the next shuffle.
+  std::unique_ptr<State> copy = game->NewInitialState(nlohmann::json::parse(ds->ToJson()));
+  std::mt19937 gen(5);
+  for (int steps = 0; steps < 200 && !state->IsTerminal() && !state->IsChanceNode(); ++steps) {
+    auto la = state->LegalActions();
+    SPIEL_CHECK_TRUE(la == copy->LegalActions());
+    std::uniform_int_distribution<size_t> pick(0, la.size() - 1);
+    open_spiel::Action a = la[pick(gen)];
+    state->ApplyAction(a);
+    copy->ApplyAction(a);
+    auto* dc = dynamic_cast<DominionState*>(copy.get());
+    for (int p = 0; p < kNumPlayers; ++p) {
+      SPIEL_CHECK_TRUE(DominionTestHarness::Hand(ds, p) == DominionTestHarness::Hand(dc, p));
+    }
+  }
+
+  // Random playout across reshuffles keeps the deck count-only.
+  for (int steps = 0; steps < 2000 && !state->IsTerminal(); ++steps) {
+    auto la = state->LegalActions();
+    std::uniform_int_distribution<size_t> pick(0, la.size() - 1);
+    state->ApplyAction(la[pick(gen)]);
+    for (int p = 0; p < kNumPlayers; ++p) SPIEL_CHECK_TRUE(ds->player_states_[p].deck_.empty());
+  }
+}
+
+// With opening hands dealt by chance, the action history alone reproduces a
+// game: shuffle seeds fix every deck order and forced moves are re-derived.
+static void TestShuffleSeedReplay() {
+  for (bool counts : {false, true}) {
+    std::shared_ptr<const Game> game =
+        LoadGame("dominion", {{"opening_chance", open_spiel::GameParameter(true)},
+                              {"counts_deck", open_spiel::GameParameter(counts)}});
+    SPIEL_CHECK_EQ(game->MaxChanceOutcomes(), open_spiel::dominion::kNumShuffleSeeds);
+    std::unique_ptr<State> state = game->NewInitialState();
+    SPIEL_CHECK_TRUE(state->IsChanceNode());
+    auto outcomes = state->ChanceOutcomes();
+    SPIEL_CHECK_EQ(static_cast<int>(outcomes.size()), open_spiel::dominion::kNumShuffleSeeds);
+    SPIEL_CHECK_FLOAT_NEAR(outcomes[0].second, 1.0 / open_spiel::dominion::kNumShuffleSeeds, 1e-12);
+
+    std::mt19937 gen(counts ? 11 : 7);
+    for (int steps = 0; steps < 1500 && !state->IsTerminal(); ++steps) {
+      auto la = state->LegalActions();
+      std::uniform_int_distribution<size_t> pick(0, la.size() - 1);
+      state->ApplyAction(la[pick(gen)]);
+    }
+    auto* ds = dynamic_cast<DominionState*>(state.get());
+    for (int p = 0; p < kNumPlayers; ++p) {
+      SPIEL_CHECK_GT(DominionTestHarness::HandSize(ds, p) + ds->player_states_[p].DeckSize(), 0);
+    }
+
+    std::unique_ptr<State> replay = game->NewInitialState();
+    for (open_spiel::Action a : state->History()) replay->ApplyAction(a);
+    SPIEL_CHECK_EQ(replay->ToJson(), state->ToJson());
+    SPIEL_CHECK_EQ(replay->InformationStateString(0), state->InformationStateString(0));
+  }
+}
+
+// Bulk replay and keyframe lookups reproduce the state after every prefix.
+static void TestKeyframedReplay() {
+  std::shared_ptr<const Game> game =
+      LoadGame("dominion", {{"opening_chance", open_spiel::GameParameter(true)}});
+  std::unique_ptr<State> state = game->NewInitialState();
+  std::vector<std::string> snapshots{state->ToJson()};
+  std::mt19937 gen(3);
+  for (int steps = 0; steps < 400 && !state->IsTerminal(); ++steps) {
+    auto la = state->LegalActions();
+    std::uniform_int_distribution<size_t> pick(0, la.size() - 1);
+    state->ApplyAction(la[pick(gen)]);
+    snapshots.push_back(state->ToJson());
+  }
+  std::vector<open_spiel::Action> history = state->History();
+  const auto& forced = dynamic_cast<const DominionState&>(*state).ForcedMoves();
+  SPIEL_CHECK_FALSE(forced.empty());
+
+  // The recorded forced moves are applied at the points they were found.
+  std::unique_ptr<State> bulk = game->NewInitialState();
+  auto* bulk_ds = dynamic_cast<DominionState*>(bulk.get());
+  bulk_ds->ReplayHistory(history, forced);
+  SPIEL_CHECK_EQ(bulk->ToJson(), state->ToJson());
+  SPIEL_CHECK_TRUE(bulk->History() == history);
+  SPIEL_CHECK_EQ(bulk_ds->ForcedMoves().size(), forced.size());
+  for (size_t i = 0; i < forced.size(); ++i) {
+    SPIEL_CHECK_EQ(bulk_ds->ForcedMoves()[i].move, forced[i].move);
+    SPIEL_CHECK_EQ(bulk_ds->ForcedMoves()[i].probe, forced[i].probe);
+    SPIEL_CHECK_EQ(bulk_ds->ForcedMoves()[i].action, forced[i].action);
+  }
+  // Replaying with ApplyAction re-derives the same forced moves.
+  std::unique_ptr<State> stepped = game->NewInitialState();
+  for (open_spiel::Action a : history) stepped->ApplyAction(a);
+  SPIEL_CHECK_EQ(dynamic_cast<DominionState&>(*stepped).ForcedMoves().size(), forced.size());
+
+  open_spiel::dominion::KeyframedReplay replay(game, history, forced, 16);
+  SPIEL_CHECK_EQ(replay.NumMoves(), static_cast<int>(history.size()));
+  for (int k = 0; k <= replay.NumMoves(); k += 7) {
+    SPIEL_CHECK_EQ(replay.StateAt(k)->ToJson(), snapshots[k]);
+  }
+  SPIEL_CHECK_EQ(replay.StateAt(replay.NumMoves())->ToJson(), snapshots.back());
+}
+
+// Binary serialization reproduces the JSON view of the state, including
+// pending effects, and is much smaller than JSON.
+static void TestBinarySerialization() {
+  for (bool counts : {false, true}) {
+    std::shared_ptr<const Game> game =
+        LoadGame("dominion", {{"counts_deck", open_spiel::GameParameter(counts)}});
+    const auto& dgame = static_cast<const open_spiel::dominion::DominionGame&>(*game);
+    std::unique_ptr<State> state = game->NewInitialState();
+    auto* ds = dynamic_cast<DominionState*>(state.get());
+    std::unique_ptr<State> reused = game->NewInitialState();
+    auto* dr = dynamic_cast<DominionState*>(reused.get());
+    std::mt19937 gen(counts ? 21 : 17);
+    size_t binary_total = 0, json_total = 0;
+    for (int steps = 0; steps < 300 && !state->IsTerminal(); ++steps) {
+      std::string bytes = ds->SerializeBinary();
+      std::string json = ds->ToJson();
+      binary_total += bytes.size();
+      json_total += json.size();
+      SPIEL_CHECK_EQ(dgame.DeserializeStateBinary(bytes)->ToJson(), json);
+      dr->DeserializeBinary(bytes);
+      SPIEL_CHECK_EQ(dr->ToJson(), json);
+      SPIEL_CHECK_TRUE(dr->LegalActions() == ds->LegalActions());
+      auto la = state->LegalActions();
+      std::uniform_int_distribution<size_t> pick(0, la.size() - 1);
+      state->ApplyAction(la[pick(gen)]);
+    }
+    SPIEL_CHECK_LE(binary_total * 10, json_total);
+  }
+
+  // Pending effect queues survive the round trip.
+  std::shared_ptr<const Game> game = LoadGame("dominion");
+  const auto& dgame = static_cast<const open_spiel::dominion::DominionGame&>(*game);
+  std::unique_ptr<State> state = game->NewInitialState();
+  auto* ds = dynamic_cast<DominionState*>(state.get());
+  GetCardSpec(open_spiel::dominion::CardName::CARD_Workshop).applyEffect(*ds, 0);
+  std::unique_ptr<State> copy = dgame.DeserializeStateBinary(ds->SerializeBinary());
+  auto* dc = dynamic_cast<DominionState*>(copy.get());
+  SPIEL_CHECK_EQ(EffectQueueSize(dc, 0), 1);
+  SPIEL_CHECK_EQ(PendingChoiceVal(dc, 0), static_cast<int>(open_spiel::dominion::PendingChoice::SelectUpToCardsFromBoard));
+  SPIEL_CHECK_EQ(dc->ToJson(), ds->ToJson());
+  SPIEL_CHECK_TRUE(dc->LegalActions() == ds->LegalActions());
+}
+
+// Trajectory files rebuild every recorded position and are far smaller than
+// per-move JSON.
+static void TestTrajectoryRoundTrip() {
+  std::shared_ptr<const Game> game = LoadGame("dominion");
+  const auto& dgame = static_cast<const open_spiel::dominion::DominionGame&>(*game);
+  std::mt19937 gen(9);
+  std::string path = (std::filesystem::temp_directory_path() /
+                      ("dominion_trajectory_test_" + std::to_string(gen()) + ".dtraj")).string();
+  std::filesystem::remove(path);
+  std::vector<std::vector<std::string>> snapshots;
+  size_t json_bytes = 0;
+  {
+    open_spiel::dominion::TrajectoryWriter writer(path);
+    for (int g = 0; g < 3; ++g) {
+      std::unique_ptr<State> state = game->NewInitialState();
+      writer.BeginGame(*dynamic_cast<DominionState*>(state.get()));
+      snapshots.push_back({state->ToJson()});
+      for (int steps = 0; steps < 200 && !state->IsTerminal(); ++steps) {
+        auto la = state->LegalActions();
+        std::uniform_int_distribution<size_t> pick(0, la.size() - 1);
+        open_spiel::Action a = la[pick(gen)];
+        open_spiel::ActionsAndProbs policy;
+        for (auto l : la) policy.push_back({l, 1.0 / la.size()});
+        float value = static_cast<float>(steps % 3) - 1.0f;
+        writer.AddStep(a, state->IsChanceNode() ? nullptr : &policy, &value);
+        state->ApplyAction(a);
+        snapshots.back().push_back(state->ToJson());
+        json_bytes += snapshots.back().back().size();
+      }
+      writer.EndGame(state->Returns());
+    }
+  }
+  // A second writer appends to the same file.
+  {
+    open_spiel::dominion::TrajectoryWriter writer(path);
+    std::unique_ptr<State> state = game->NewInitialState();
+    writer.BeginGame(*dynamic_cast<DominionState*>(state.get()));
+    writer.EndGame(state->Returns());
+  }
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  SPIEL_CHECK_LE(static_cast<size_t>(file.tellg()) * 10, json_bytes);
+
+  open_spiel::dominion::TrajectoryReader reader(path);
+  open_spiel::dominion::Trajectory traj;
+  for (size_t g = 0; g < snapshots.size(); ++g) {
+    SPIEL_CHECK_TRUE(reader.Next(&traj));
+    SPIEL_CHECK_EQ(traj.steps.size() + 1, snapshots[g].size());
+    SPIEL_CHECK_EQ(traj.returns.size(), static_cast<size_t>(kNumPlayers));
+    for (size_t k = 0; k < snapshots[g].size(); k += 11) {
+      SPIEL_CHECK_EQ(traj.StateAt(dgame, static_cast<int>(k))->ToJson(), snapshots[g][k]);
+    }
+    std::unique_ptr<State> last = traj.StateAt(dgame, static_cast<int>(traj.steps.size()));
+    SPIEL_CHECK_EQ(last->ToJson(), snapshots[g].back());
+    SPIEL_CHECK_TRUE(traj.steps[0].has_value);
+    SPIEL_CHECK_FALSE(traj.steps[0].policy.empty());
+  }
+  SPIEL_CHECK_TRUE(reader.Next(&traj));
+  SPIEL_CHECK_TRUE(traj.steps.empty());
+  SPIEL_CHECK_FALSE(reader.Next(&traj));
+  std::filesystem::remove(path);
+}
+
+// Stored positions carry observation, legal mask, policy and state, are
+// visible to a second mapping of the file, and can be sampled in place.
+static void TestReplayStore() {
+  using open_spiel::dominion::ReplayStore;
+  using open_spiel::dominion::StoredPosition;
+  SPIEL_CHECK_EQ(open_spiel::dominion::ActionIds::Shuffle(), open_spiel::dominion::kNumPlayerActions);
+  std::shared_ptr<const Game> game = LoadGame("dominion");
+  const auto& dgame = static_cast<const open_spiel::dominion::DominionGame&>(*game);
+  std::mt19937 gen(13);
+  std::string path = (std::filesystem::temp_directory_path() /
+                      ("dominion_replay_store_test_" + std::to_string(gen()) + ".bin")).string();
+  auto store = ReplayStore::Create(path, 40);
+  auto other = ReplayStore::Open(path);
+
+  std::unique_ptr<State> state = game->NewInitialState();
+  std::vector<std::string> jsons;
+  while (jsons.size() < 50 && !state->IsTerminal()) {
+    auto la = state->LegalActions();
+    if (!state->IsChanceNode()) {
+      open_spiel::ActionsAndProbs policy{{la[0], 0.75}};
+      if (la.size() > 1) policy.push_back({la.back(), 0.25});
+      auto& writer = jsons.size() % 2 ? *other : *store;
+      bool ok = writer.Append(*dynamic_cast<DominionState*>(state.get()), policy, 1.0f,
+                              jsons.size() == 7 ? 1000.0f : 1.0f);
+      SPIEL_CHECK_EQ(ok, jsons.size() < 40);
+      jsons.push_back(state->ToJson());
+    }
+    std::uniform_int_distribution<size_t> pick(0, la.size() - 1);
+    state->ApplyAction(la[pick(gen)]);
+  }
+  SPIEL_CHECK_EQ(store->Size(), 40u);
+  SPIEL_CHECK_EQ(other->Size(), 40u);
+
+  for (uint64_t i = 0; i < store->Size(); i += 5) {
+    const StoredPosition& rec = store->At(i);
+    std::unique_ptr<State> s = store->StateAt(dgame, i);
+    SPIEL_CHECK_EQ(s->ToJson(), jsons[i]);
+    auto* ds = dynamic_cast<DominionState*>(s.get());
+    uint8_t obs[open_spiel::dominion::kObservationBytes];
+    ds->ObservationBytes(rec.player, obs);
+    SPIEL_CHECK_TRUE(std::memcmp(obs, rec.observation, sizeof(obs)) == 0);
+    auto la = s->LegalActions();
+    SPIEL_CHECK_TRUE(rec.IsLegal(la[0]));
+    SPIEL_CHECK_FLOAT_NEAR(rec.Policy(la[0]), la.size() > 1 ? 0.75 : 1.0, 1e-4);
+  }
+
+  std::mt19937_64 rng(1);
+  std::vector<const StoredPosition*> batch;
+  store->SampleUniform(16, rng, &batch);
+  SPIEL_CHECK_EQ(batch.size(), 16u);
+  other->SamplePrioritized(64, rng, &batch);
+  int heavy = 0;
+  for (const auto* rec : batch) heavy += rec == &other->At(7);
+  SPIEL_CHECK_GT(heavy, 48);
+  store->SetPriority(7, 0.0f);
+  other->SamplePrioritized(64, rng, &batch);
+  for (const auto* rec : batch) SPIEL_CHECK_TRUE(rec != &other->At(7));
+  // Priority changes through one mapping reach samplers on the other.
+  for (uint64_t i = 0; i < other->Size(); ++i) other->SetPriority(i, i == 3 ? 2.0f : 0.0f);
+  store->SamplePrioritized(32, rng, &batch);
+  SPIEL_CHECK_EQ(batch.size(), 32u);
+  for (const auto* rec : batch) SPIEL_CHECK_TRUE(rec == &store->At(3));
+  // With every slot still in flight the samplers come back empty-handed.
+  std::vector<StoredPosition*> slots;
+  for (uint64_t i = 0; i < store->Size(); ++i) {
+    slots.push_back(const_cast<StoredPosition*>(&store->At(i)));
+  }
+  for (StoredPosition* rec : slots) rec->ready = 0;
+  store->SampleUniform(16, rng, &batch);
+  SPIEL_CHECK_TRUE(batch.empty());
+  store->SamplePrioritized(16, rng, &batch);
+  SPIEL_CHECK_TRUE(batch.empty());
+  for (StoredPosition* rec : slots) rec->ready = 1;
+
+  store.reset();
+  other.reset();
+  SPIEL_CHECK_EQ(ReplayStore::Open(path)->Size(), 40u);
+  std::filesystem::remove(path);
+}
+
+static void TestKingdomParameter() {
+  using open_spiel::dominion::CardName;
+  std::shared_ptr<const Game> game = LoadGame(
+      "dominion", {{"kingdom", open_spiel::GameParameter(std::string("Chapel,ThroneRoom,Witch"))}});
+  std::unique_ptr<State> state = game->NewInitialState();
+  auto* ds = dynamic_cast<DominionState*>(state.get());
+  const auto& supply = DominionTestHarness::SupplyCounts(ds);
+  SPIEL_CHECK_EQ(supply[static_cast<int>(CardName::CARD_Chapel)], 10);
+  SPIEL_CHECK_EQ(supply[static_cast<int>(CardName::CARD_ThroneRoom)], 10);
+  SPIEL_CHECK_EQ(supply[static_cast<int>(CardName::CARD_Witch)], 10);
+  SPIEL_CHECK_EQ(supply[static_cast<int>(CardName::CARD_Market)], 0);
+  SPIEL_CHECK_EQ(supply[static_cast<int>(CardName::CARD_Province)], 8);
+
+  // "none" leaves only the basic piles; random play still ends.
+  game = LoadGame("dominion", {{"kingdom", open_spiel::GameParameter(std::string("none"))}});
+  state = game->NewInitialState();
+  ds = dynamic_cast<DominionState*>(state.get());
+  for (int j = static_cast<int>(CardName::CARD_Curse) + 1; j < open_spiel::dominion::kNumSupplyPiles; ++j) {
+    SPIEL_CHECK_EQ(DominionTestHarness::SupplyCounts(ds)[j], 0);
+  }
+  std::mt19937 gen(5);
+  for (int steps = 0; steps < 5000 && !state->IsTerminal(); ++steps) {
+    auto la = state->LegalActions();
+    std::uniform_int_distribution<size_t> pick(0, la.size() - 1);
+    state->ApplyAction(la[pick(gen)]);
+  }
+  SPIEL_CHECK_TRUE(state->IsTerminal());
+}
+
+static void TestInstrumentation() {
+  namespace instr = open_spiel::dominion::instrument;
+  instr::Reset();
+  std::shared_ptr<const Game> game = LoadGame("dominion");
+  std::unique_ptr<State> state = game->NewInitialState();
+  std::mt19937 gen(9);
+  for (int steps = 0; steps < 200 && !state->IsTerminal(); ++steps) {
+    auto la = state->LegalActions();
+    std::uniform_int_distribution<size_t> pick(0, la.size() - 1);
+    state->ApplyAction(la[pick(gen)]);
+  }
+  std::unique_ptr<State> copy = state->Clone();
+  static_cast<DominionState*>(copy.get())->CopyFrom(static_cast<const DominionState&>(*state));
+  auto totals = instr::Snapshot();
+  auto at = [&](instr::Probe p) { return totals[static_cast<int>(p)]; };
+  if (instr::Enabled()) {
+    SPIEL_CHECK_GE(at(instr::Probe::kLegalActions).count, 200u);
+    SPIEL_CHECK_EQ(at(instr::Probe::kClone).count, 1u);
+    SPIEL_CHECK_EQ(at(instr::Probe::kCopyFrom).count, 1u);
+    SPIEL_CHECK_GT(at(instr::Probe::kDrawCardsFor).count, 0u);
+    SPIEL_CHECK_GT(at(instr::Probe::kApplyEndBuy).ticks, 0u);
+  } else {
+    for (const auto& t : totals) SPIEL_CHECK_EQ(t.count, 0u);
+  }
+  nlohmann::json report = nlohmann::json::parse(instr::ReportJson());
+  SPIEL_CHECK_EQ(report["enabled"].get<bool>(), instr::Enabled());
+  SPIEL_CHECK_EQ(report["probes"]["Clone"]["count"].get<uint64_t>(),
+                 at(instr::Probe::kClone).count);
+  instr::Reset();
+  SPIEL_CHECK_EQ(instr::Snapshot()[static_cast<int>(instr::Probe::kClone)].count, 0u);
+}
+
+// Heap allocation budgets for the hot paths, measured on random playouts.
+// These are ceilings at the current cost; lower them as paths are made
+// allocation-free so regressions fail here.
+static void TestAllocationBudgets() {
+  using open_spiel::dominion::alloc::AllocationScope;
+  uint64_t max_legal = 0, max_clone = 0, max_apply = 0;
+  double max_per_move = 0;
+  for (bool counts : {false, true}) {
+    std::shared_ptr<const Game> game =
+        LoadGame("dominion", {{"counts_deck", open_spiel::GameParameter(counts)}});
+    std::mt19937 gen(counts ? 8 : 3);
+    for (int g = 0; g < 4; ++g) {
+      std::unique_ptr<State> state = game->NewInitialState();
+      uint64_t game_allocs = 0;
+      int moves = 0;
+      std::vector<open_spiel::Action> la;
+      for (; moves < 3000 && !state->IsTerminal(); ++moves) {
+        AllocationScope scope;
+        la = state->LegalActions();
+        max_legal = std::max(max_legal, scope.Allocations());
+        game_allocs += scope.Allocations();
+        scope.Restart();
+        { std::unique_ptr<State> copy = state->Clone(); }
+        max_clone = std::max(max_clone, scope.Allocations());
+        std::uniform_int_distribution<size_t> pick(0, la.size() - 1);
+        open_spiel::Action a = la[pick(gen)];
+        scope.Restart();
+        state->ApplyAction(a);
+        max_apply = std::max(max_apply, scope.Allocations());
+        game_allocs += scope.Allocations();
+      }
+      max_per_move = std::max(max_per_move, static_cast<double>(game_allocs) / moves);
+    }
+  }
+  SPIEL_CHECK_LE(max_legal, 6u);
+  // One of them is the ForcedMoves() record.
+  SPIEL_CHECK_LE(max_clone, 13u);
+  // Includes forced follow-up moves and draws applied inside one call.
+  SPIEL_CHECK_LE(max_apply, 64u);
+  // LegalActions + ApplyAction per move, averaged over each full game.
+  SPIEL_CHECK_LE(max_per_move, 14.0);
+}
+
+// Every second game is sampled; the written file is Chrome trace-event JSON
+// holding the game, its turns and the engine spans inside them.
+static void TestTrace() {
+  namespace trace = open_spiel::dominion::trace;
+  trace::TraceOptions options;
+  options.sample_every = 2;
+  trace::Enable(options);
+  std::shared_ptr<const Game> game = LoadGame("dominion");
+  std::mt19937 gen(21);
+  for (int g = 0; g < 2; ++g) {
+    trace::GameSpan span;
+    SPIEL_CHECK_EQ(trace::Sampled(), g == 0);
+    std::unique_ptr<State> state = game->NewInitialState();
+    for (int moves = 0; moves < 400 && !state->IsTerminal(); ++moves) {
+      auto la = state->LegalActions();
+      std::uniform_int_distribution<size_t> pick(0, la.size() - 1);
+      state->ApplyAction(la[pick(gen)]);
+    }
+  }
+  SPIEL_CHECK_FALSE(trace::Sampled());
+  std::string path = (std::filesystem::temp_directory_path() /
+                      ("dominion_trace_test_" + std::to_string(gen()) + ".json")).string();
+  SPIEL_CHECK_TRUE(trace::WriteChromeTrace(path));
+  std::ifstream in(path);
+  nlohmann::json doc = nlohmann::json::parse(in);
+  std::filesystem::remove(path);
+  std::map<std::string, int> counts;
+  for (const auto& e : doc["traceEvents"]) {
+    SPIEL_CHECK_EQ(e["ph"].get<std::string>(), "X");
+    SPIEL_CHECK_GE(e["dur"].get<double>(), 0.0);
+    counts[e["name"].get<std::string>()] += 1;
+  }
+  SPIEL_CHECK_EQ(counts["game"], 1);
+  SPIEL_CHECK_GT(counts["turn"], 1);
+  SPIEL_CHECK_GT(counts["ApplyAction"], 100);
+  SPIEL_CHECK_GT(counts["Shuffle"], 0);
+  trace::Disable();
+  trace::Clear();
+  {
+    trace::GameSpan span;
+    SPIEL_CHECK_FALSE(trace::Sampled());
+  }
+}
+
+// Bucket layout, percentiles and merging of LogLinearHistogram, and the
+// per-probe histograms fed by instrumented builds.
+static void TestLatencyHistogram() {
+  using open_spiel::dominion::LogLinearHistogram;
+  using H = LogLinearHistogram;
+  // Buckets tile the value range without gaps, and each spans <= 1/16 of its
+  // lower bound.
+  SPIEL_CHECK_EQ(H::BucketIndex(0), 0);
+  SPIEL_CHECK_EQ(H::BucketIndex(UINT64_MAX), H::kNumBuckets - 1);
+  SPIEL_CHECK_EQ(H::BucketHigh(H::kNumBuckets - 1), UINT64_MAX);
+  for (int b = 1; b < H::kNumBuckets; ++b) {
+    SPIEL_CHECK_EQ(H::BucketLow(b), H::BucketHigh(b - 1) + 1);
+    SPIEL_CHECK_EQ(H::BucketIndex(H::BucketLow(b)), b);
+    SPIEL_CHECK_EQ(H::BucketIndex(H::BucketHigh(b)), b);
+    SPIEL_CHECK_LE(H::BucketHigh(b) - H::BucketLow(b), H::BucketLow(b) / H::kSubBuckets);
+  }
+
+  H a, b;
+  SPIEL_CHECK_EQ(a.ValueAtPercentile(50), 0u);
+  for (uint64_t v = 1; v <= 1000; ++v) a.Record(v);
+  b.RecordCount(100000, 10);
+  SPIEL_CHECK_EQ(a.Min(), 1u);
+  uint64_t p50 = a.ValueAtPercentile(50);
+  SPIEL_CHECK_GE(p50, 500u);
+  SPIEL_CHECK_LE(p50, 500u + 500u / H::kSubBuckets);
+  a.Merge(b);
+  SPIEL_CHECK_EQ(a.Count(), 1010u);
+  SPIEL_CHECK_LE(a.ValueAtPercentile(99), 1000u + 1000u / H::kSubBuckets);
+  SPIEL_CHECK_GE(a.ValueAtPercentile(99.9), 100000u);
+  SPIEL_CHECK_EQ(a.ValueAtPercentile(100), a.Max());
+  a.Clear();
+  SPIEL_CHECK_EQ(a.Count(), 0u);
+
+  namespace instr = open_spiel::dominion::instrument;
+  instr::Reset();
+  std::shared_ptr<const Game> game = LoadGame("dominion");
+  std::unique_ptr<State> state = game->NewInitialState();
+  for (int i = 0; i < 50 && !state->IsTerminal(); ++i) {
+    std::unique_ptr<State> copy = state->Clone();
+    state->ApplyAction(state->LegalActions()[0]);
+  }
+  auto totals = instr::Snapshot();
+  for (instr::Probe p : {instr::Probe::kLegalActions, instr::Probe::kClone}) {
+    SPIEL_CHECK_EQ(instr::Histogram(p).Count(), totals[static_cast<int>(p)].count);
+  }
+  nlohmann::json report = nlohmann::json::parse(instr::ReportJson());
+  SPIEL_CHECK_LE(report["probes"]["Clone"]["p50"].get<uint64_t>(),
+                 report["probes"]["Clone"]["p999"].get<uint64_t>());
+  instr::Reset();
+  SPIEL_CHECK_EQ(instr::Histogram(instr::Probe::kClone).Count(), 0u);
+}
+
+// Every game is played exactly once, and a game's moves depend only on the
+// run seed and its index, not on how many threads shared the work.
+static void TestSelfPlay() {
+  namespace dom = open_spiel::dominion;
+  std::shared_ptr<const Game> game =
+      LoadGame("dominion", {{"opening_chance", open_spiel::GameParameter(true)}});
+  const auto& dgame = static_cast<const dom::DominionGame&>(*game);
+  std::vector<dom::BotFactory> seats = {dom::MakeBotFactory("bigmoney"),
+                                        dom::MakeBotFactory("random")};
+  dom::SelfPlayConfig config;
+  config.num_games = 24;
+  config.seed = 5;
+  config.max_moves = 3000;
+  auto run = [&](int threads) {
+    config.num_threads = threads;
+    std::vector<std::vector<open_spiel::Action>> actions(config.num_games);
+    std::vector<int> seen(config.num_games, 0);
+    dom::SelfPlayStats stats =
+        dom::RunSelfPlay(dgame, config, seats, [&](const dom::SelfPlayGame& g) {
+          seen[g.index] += 1;
+          SPIEL_CHECK_TRUE(g.initial->IsChanceNode());
+          SPIEL_CHECK_EQ(static_cast<int>(g.actions.size()), g.moves);
+          actions[g.index] = g.actions;
+        });
+    SPIEL_CHECK_EQ(stats.games, config.num_games);
+    SPIEL_CHECK_EQ(stats.threads, threads);
+    for (int n : seen) SPIEL_CHECK_EQ(n, 1);
+    return std::make_pair(stats, actions);
+  };
+  auto [serial, serial_actions] = run(1);
+  auto [parallel, parallel_actions] = run(4);
+  SPIEL_CHECK_TRUE(serial_actions == parallel_actions);
+  SPIEL_CHECK_EQ(serial.moves, parallel.moves);
+  SPIEL_CHECK_EQ(serial.steals, 0);
+  // Big Money beats uniform random play.
+  SPIEL_CHECK_EQ(serial.capped, 0);
+  SPIEL_CHECK_GT(serial.total_returns[0], serial.total_returns[1]);
+}
+
+// Outputs mirror each slot's state, finished games are credited and
+// restarted in place, and the batch is reproducible from its seed.
+static void TestBatchEnv() {
+  namespace dom = open_spiel::dominion;
+  std::shared_ptr<const Game> game =
+      LoadGame("dominion", {{"opening_chance", open_spiel::GameParameter(true)}});
+  constexpr int kBatch = 6;
+  dom::BatchEnv env(game, kBatch, 17, /*max_moves=*/400);
+  dom::BatchEnv twin(game, kBatch, 17, /*max_moves=*/400);
+  std::mt19937 gen(4);
+  std::vector<open_spiel::Action> actions(kBatch);
+  int terminals = 0, truncations = 0;
+  for (int step = 0; step < 1500; ++step) {
+    for (int i = 0; i < kBatch; ++i) {
+      const dom::DominionState& s = env.GameState(i);
+      SPIEL_CHECK_FALSE(s.IsChanceNode() || s.IsTerminal());
+      SPIEL_CHECK_EQ(env.CurrentPlayers()[i], s.CurrentPlayer());
+      std::vector<uint8_t> obs(dom::kObservationBytes);
+      s.ObservationBytes(s.CurrentPlayer(), obs.data());
+      SPIEL_CHECK_EQ(std::memcmp(obs.data(), env.Observations() + i * dom::kObservationBytes,
+                                 obs.size()), 0);
+      std::vector<open_spiel::Action> legal = s.LegalActions();
+      const uint8_t* mask = env.LegalMask() + i * dom::BatchEnv::kLegalMaskStride;
+      SPIEL_CHECK_EQ(
+          static_cast<size_t>(std::count(mask, mask + dom::BatchEnv::kLegalMaskStride, 1)),
+          legal.size());
+      for (open_spiel::Action a : legal) SPIEL_CHECK_EQ(mask[a], 1);
+      actions[i] = legal[std::uniform_int_distribution<size_t>(0, legal.size() - 1)(gen)];
+    }
+    env.Step(actions);
+    twin.Step(actions);
+    for (int i = 0; i < kBatch; ++i) {
+      const float* r = env.Rewards() + i * dom::kNumPlayers;
+      if (env.Terminals()[i]) {
+        terminals += 1;
+        SPIEL_CHECK_EQ(r[0] + r[1], 0.0f);
+      } else {
+        SPIEL_CHECK_TRUE(r[0] == 0.0f && r[1] == 0.0f);
+      }
+      truncations += env.Truncations()[i];
+    }
+    SPIEL_CHECK_EQ(std::memcmp(env.Observations(), twin.Observations(),
+                               kBatch * dom::kObservationBytes), 0);
+  }
+  SPIEL_CHECK_GT(terminals + truncations, 0);
+  SPIEL_CHECK_EQ(env.EpisodesCompleted(), terminals + truncations);
+}
+
+// The SoA kernels agree with the per-state PlayerState helpers on positions
+// from random playouts, and Store() writes the results back.
+static void TestCountBatch() {
+  namespace dom = open_spiel::dominion;
+  using dom::CardName;
+  std::shared_ptr<const Game> game = LoadGame("dominion");
+  std::mt19937 gen(31);
+  constexpr int kGames = 9;
+  std::vector<std::unique_ptr<State>> states;
+  for (int g = 0; g < kGames; ++g) {
+    std::unique_ptr<State> s = game->NewInitialState();
+    for (int moves = 0; moves < 25 * g && !s->IsTerminal(); ++moves) {
+      auto la = s->LegalActions();
+      s->ApplyAction(la[std::uniform_int_distribution<size_t>(0, la.size() - 1)(gen)]);
+    }
+    states.push_back(std::move(s));
+  }
+  dom::CountBatch batch(kGames);
+  for (int g = 0; g < kGames; ++g) {
+    batch.Load(g, static_cast<const DominionState&>(*states[g]));
+    SPIEL_CHECK_EQ(reinterpret_cast<uintptr_t>(batch.Hand(g, 1)) % dom::kCountRowBytes, 0u);
+  }
+
+  std::vector<int32_t> sizes(kGames * dom::kNumPlayers), coins(sizes.size());
+  batch.HandSizes(sizes.data());
+  batch.TreasureCoins(coins.data());
+  for (int g = 0; g < kGames; ++g) {
+    const auto& ds = static_cast<const DominionState&>(*states[g]);
+    for (int p = 0; p < dom::kNumPlayers; ++p) {
+      const auto& ps = ds.player_states_[p];
+      SPIEL_CHECK_EQ(sizes[g * dom::kNumPlayers + p], ps.TotalHandSize());
+      int expected = ps.HandCount(CardName::CARD_Copper) + 2 * ps.HandCount(CardName::CARD_Silver) +
+                     3 * ps.HandCount(CardName::CARD_Gold);
+      SPIEL_CHECK_EQ(coins[g * dom::kNumPlayers + p], expected);
+    }
+  }
+
+  std::vector<int32_t> player(kGames);
+  for (int g = 0; g < kGames; ++g) player[g] = g % dom::kNumPlayers;
+  batch.CleanupMerge(player.data());
+  for (int g = 0; g < kGames; ++g) {
+    auto& ds = static_cast<DominionState&>(*states[g]);
+    auto expected = ds.player_states_;
+    auto& ps = expected[player[g]];
+    for (CardName cn : ds.play_area_) ps.discard_counts_[static_cast<int>(cn)] += 1;
+    ps.MoveHandToDiscard();
+    ps.public_cards_.OnCleanup();
+    batch.Store(g, &ds);
+    SPIEL_CHECK_TRUE(ds.play_area_.empty());
+    for (int p = 0; p < dom::kNumPlayers; ++p) {
+      const auto& stored = ds.player_states_[p];
+      SPIEL_CHECK_TRUE(stored.hand_counts_ == expected[p].hand_counts_);
+      SPIEL_CHECK_TRUE(stored.discard_counts_ == expected[p].discard_counts_);
+      for (int j = 0; j < dom::kNumSupplyPiles; ++j) {
+        SPIEL_CHECK_EQ(stored.public_cards_.in_play[j], 0);
+        SPIEL_CHECK_LE(stored.public_cards_.known_hand[j], stored.hand_counts_[j]);
+        SPIEL_CHECK_LE(stored.public_cards_.known_discard[j], stored.discard_counts_[j]);
+      }
+    }
+    const auto& merged = ds.player_states_[player[g]].public_cards_;
+    SPIEL_CHECK_TRUE(merged.known_hand == ps.public_cards_.known_hand);
+    SPIEL_CHECK_TRUE(merged.known_discard == ps.public_cards_.known_discard);
+  }
+
+  batch.MoveHandToDiscard();
+  batch.HandSizes(sizes.data());
+  for (int32_t n : sizes) SPIEL_CHECK_EQ(n, 0);
+  for (int g = 0; g < kGames; ++g) {
+    for (int j = dom::kNumSupplyPiles; j < dom::kCountRowBytes; ++j) {
+      SPIEL_CHECK_EQ(batch.Discard(g, 0)[j] | batch.Supply(g)[j], 0);
+    }
+  }
+}
+
+// Every pile-kernel implementation the CPU supports matches the scalar one,
+// and games played with different active kernels stay identical.
+static void TestCountKernels() {
+  namespace ck = open_spiel::dominion::count_kernels;
+  std::vector<const ck::PileKernels*> impls = {&ck::ScalarPileKernels()};
+  if (ck::Avx2PileKernels()) impls.push_back(ck::Avx2PileKernels());
+  std::mt19937 gen(12);
+  std::uniform_int_distribution<int> count(0, 70);
+  for (int trial = 0; trial < 200; ++trial) {
+    std::array<int, ck::kPileWidth> a{}, b{}, w{};
+    for (int j = 0; j < ck::kPileWidth; ++j) {
+      // Sparse like real hands, with the last (scalar-tail) pile exercised.
+      a[j] = gen() % 3 == 0 || j == ck::kPileWidth - 1 ? count(gen) : 0;
+      b[j] = count(gen);
+      w[j] = count(gen) % 4;
+    }
+    const ck::PileKernels& ref = ck::ScalarPileKernels();
+    for (const ck::PileKernels* k : impls) {
+      SPIEL_CHECK_EQ(k->sum(a.data()), ref.sum(a.data()));
+      SPIEL_CHECK_EQ(k->dot(a.data(), w.data()), ref.dot(a.data(), w.data()));
+      auto dst = b, src = a, ref_dst = b, ref_src = a;
+      k->move(dst.data(), src.data());
+      ref.move(ref_dst.data(), ref_src.data());
+      SPIEL_CHECK_TRUE(dst == ref_dst && src == ref_src);
+      for (int v : src) SPIEL_CHECK_EQ(v, 0);
+    }
+  }
+
+  const ck::PileKernels& active = ck::ActivePileKernels();
+  SPIEL_CHECK_TRUE(ck::Avx2PileKernels() == nullptr || &active == ck::Avx2PileKernels());
+  std::shared_ptr<const Game> game = LoadGame("dominion");
+  std::unique_ptr<State> scalar = game->NewInitialState();
+  std::unique_ptr<State> vector = scalar->Clone();
+  for (int moves = 0; moves < 1500 && !scalar->IsTerminal(); ++moves) {
+    ck::SetActivePileKernels(ck::ScalarPileKernels());
+    std::vector<open_spiel::Action> la = scalar->LegalActions();
+    std::string before = scalar->ToString();
+    ck::SetActivePileKernels(active);
+    SPIEL_CHECK_TRUE(vector->LegalActions() == la);
+    SPIEL_CHECK_EQ(vector->ToString(), before);
+    open_spiel::Action a = la[std::uniform_int_distribution<size_t>(0, la.size() - 1)(gen)];
+    vector->ApplyAction(a);
+    ck::SetActivePileKernels(ck::ScalarPileKernels());
+    scalar->ApplyAction(a);
+  }
+  ck::SetActivePileKernels(active);
+  SPIEL_CHECK_EQ(vector->ToString(), scalar->ToString());
+}
+
+// Every strategy finishes its games, beats uniform random play, and uses its
+// kingdom card; the Chapel engine trashes.
+static void TestHeuristicBots() {
+  namespace dom = open_spiel::dominion;
+  std::shared_ptr<const Game> game = LoadGame(
+      "dominion", {{"opening_chance", open_spiel::GameParameter(true)},
+                   {"kingdom", open_spiel::GameParameter(std::string(
+                                   "Smithy,Militia,Witch,Chapel,Laboratory,Village,Market,"
+                                   "Cellar,Moat,ThroneRoom"))}});
+  const auto& dgame = static_cast<const dom::DominionGame&>(*game);
+  const std::pair<dom::HeuristicStrategy, CardName> cases[] = {
+      {dom::HeuristicStrategy::kBigMoney, CardName::CARD_Gold},
+      {dom::HeuristicStrategy::kBigMoneySmithy, CardName::CARD_Smithy},
+      {dom::HeuristicStrategy::kBigMoneyMilitia, CardName::CARD_Militia},
+      {dom::HeuristicStrategy::kBigMoneyWitch, CardName::CARD_Witch},
+      {dom::HeuristicStrategy::kChapelEngine, CardName::CARD_Chapel},
+  };
+  for (const auto& [strategy, card] : cases) {
+    std::string name = dom::HeuristicStrategyName(strategy);
+    dom::HeuristicStrategy parsed;
+    SPIEL_CHECK_TRUE(dom::ParseHeuristicStrategy(name, &parsed));
+    SPIEL_CHECK_TRUE(parsed == strategy);
+    std::vector<dom::BotFactory> seats = {dom::MakeBotFactory(name),
+                                          dom::MakeBotFactory("random")};
+    dom::SelfPlayConfig config;
+    config.num_games = 8;
+    config.num_threads = 1;
+    config.seed = 11;
+    config.max_moves = 3000;
+    int bought = 0, trashed = 0;
+    dom::SelfPlayStats stats = dom::RunSelfPlay(dgame, config, seats, [&](const dom::SelfPlayGame& g) {
+      std::unique_ptr<State> s = g.initial->Clone();
+      for (open_spiel::Action a : g.actions) {
+        if (!s->IsChanceNode() && s->CurrentPlayer() == 0) {
+          bought += a == dom::ActionIds::BuyFromSupply(static_cast<int>(card));
+          trashed += a >= dom::ActionIds::TrashHandBase() && a < dom::ActionIds::TrashHandSelectFinish();
+        }
+        s->ApplyAction(a);
+      }
+      SPIEL_CHECK_TRUE(s->IsTerminal());
+    });
+    SPIEL_CHECK_EQ(stats.capped, 0);
+    SPIEL_CHECK_GT(stats.total_returns[0], stats.total_returns[1]);
+    SPIEL_CHECK_GT(bought, 0);
+    if (strategy == dom::HeuristicStrategy::kChapelEngine) SPIEL_CHECK_GT(trashed, 0);
+  }
+  SPIEL_CHECK_FALSE(dom::ParseHeuristicStrategy("nope", nullptr));
+}
+
+// CopyFrom into a reused state matches a clone and plays on identically; a
+// search spends every simulation under the root, is reproducible from its
+// seed, and keeps the subtree of the moves actually played.
+static void TestMcts() {
+  namespace dom = open_spiel::dominion;
+  std::shared_ptr<const Game> game = LoadGame(
+      "dominion", {{"opening_chance", open_spiel::GameParameter(true)},
+                   {"kingdom", open_spiel::GameParameter(std::string(
+                                   "Militia,Chapel,ThroneRoom,Cellar,Smithy,Village,Witch,"
+                                   "Workshop,Remodel,Mine"))}});
+  std::mt19937 gen(9);
+  std::unique_ptr<State> state = game->NewInitialState();
+  std::unique_ptr<State> scratch = game->NewInitialState();
+  auto& copy = static_cast<dom::DominionState&>(*scratch);
+  std::vector<open_spiel::Action> buffer;
+  for (int step = 0; step < 300 && !state->IsTerminal(); ++step) {
+    const auto& src = static_cast<const dom::DominionState&>(*state);
+    copy.CopyFrom(src);
+    SPIEL_CHECK_EQ(copy.SerializeBinary(), src.SerializeBinary());
+    SPIEL_CHECK_TRUE(copy.FullHistory() == src.FullHistory());
+    std::vector<open_spiel::Action> la = state->LegalActions();
+    SPIEL_CHECK_TRUE(copy.LegalActions() == la);
+    copy.LegalActions(&buffer);
+    SPIEL_CHECK_TRUE(buffer == la);
+    open_spiel::Action a = la[std::uniform_int_distribution<size_t>(0, la.size() - 1)(gen)];
+    state->ApplyAction(a);
+    copy.ApplyAction(a);
+    SPIEL_CHECK_EQ(copy.ToString(), state->ToString());
+  }
+
+  dom::MctsConfig config;
+  config.simulations = 48;
+  config.max_rollout_moves = 300;
+  config.seed = 5;
+  uint64_t stream = 17;
+  std::unique_ptr<State> root = game->NewInitialState();
+  while (root->IsChanceNode()) root->ApplyAction(dom::SampleChanceOutcome(*root, stream));
+  const auto& droot = static_cast<const dom::DominionState&>(*root);
+  dom::MctsSearch search(config);
+  open_spiel::Action chosen = search.Search(droot);
+  std::vector<open_spiel::Action> la = root->LegalActions();
+  SPIEL_CHECK_TRUE(std::find(la.begin(), la.end(), chosen) != la.end());
+  SPIEL_CHECK_EQ(search.Stats().simulations, config.simulations);
+  SPIEL_CHECK_EQ(search.Stats().reused_nodes, 0);
+  SPIEL_CHECK_EQ(search.GetNode(0).visits.load(), config.simulations);
+  std::array<int, dom::kNumPlayerActions> counts;
+  search.RootVisitCounts(&counts);
+  int total = 0;
+  for (int c : counts) total += c;
+  SPIEL_CHECK_EQ(total, config.simulations);
+  SPIEL_CHECK_EQ(*std::max_element(counts.begin(), counts.end()), counts[chosen]);
+
+  dom::MctsSearch again(config);
+  SPIEL_CHECK_EQ(again.Search(droot), chosen);
+  std::array<int, dom::kNumPlayerActions> again_counts;
+  again.RootVisitCounts(&again_counts);
+  SPIEL_CHECK_TRUE(again_counts == counts);
+
+  // The chosen child's statistics survive as the next root.
+  const int carried = counts[chosen];
+  root->ApplyAction(chosen);
+  while (root->IsChanceNode()) root->ApplyAction(dom::SampleChanceOutcome(*root, stream));
+  SPIEL_CHECK_FALSE(root->IsTerminal());
+  search.Search(static_cast<const dom::DominionState&>(*root));
+  SPIEL_CHECK_GT(search.Stats().reused_nodes, 0);
+  SPIEL_CHECK_EQ(search.GetNode(0).visits.load(), carried + config.simulations);
+  SPIEL_CHECK_LE(search.Stats().nodes, config.max_nodes);
+}
+
+// Several threads share one tree from an out-of-turn decision (discarding to
+// Militia): every simulation is counted once, virtual losses are all undone,
+// and the tree holds edges of both players.
+static void TestParallelMcts() {
+  namespace dom = open_spiel::dominion;
+  std::shared_ptr<const Game> game = LoadGame(
+      "dominion", {{"opening_chance", open_spiel::GameParameter(true)},
+                   {"kingdom", open_spiel::GameParameter(std::string(
+                                   "Militia,Village,Smithy,Market,Laboratory,Festival,Workshop,"
+                                   "Gardens,Witch,Moneylender"))}});
+  std::mt19937 gen(21);
+  std::unique_ptr<State> state = game->NewInitialState();
+  auto is_discard = [](open_spiel::Action a) {
+    return a >= dom::ActionIds::DiscardHandBase() && a < dom::ActionIds::DiscardHandSelectFinish();
+  };
+  for (;;) {
+    if (state->IsTerminal()) state = game->NewInitialState();
+    std::vector<open_spiel::Action> la = state->LegalActions();
+    const auto& history = state->FullHistory();
+    if (!state->IsChanceNode() && !history.empty() && history.back().player >= 0 &&
+        history.back().player != state->CurrentPlayer() &&
+        std::any_of(la.begin(), la.end(), is_discard)) {
+      break;
+    }
+    state->ApplyAction(la[std::uniform_int_distribution<size_t>(0, la.size() - 1)(gen)]);
+  }
+  const open_spiel::Player victim = state->CurrentPlayer();
+
+  dom::MctsConfig config;
+  config.simulations = 64;
+  config.num_threads = 4;
+  config.max_rollout_moves = 300;
+  config.seed = 8;
+  dom::MctsSearch search(config);
+  open_spiel::Action chosen = search.Search(static_cast<const dom::DominionState&>(*state));
+  SPIEL_CHECK_TRUE(is_discard(chosen));
+  SPIEL_CHECK_EQ(search.Stats().threads, 4);
+  SPIEL_CHECK_EQ(search.GetNode(0).visits.load(), config.simulations);
+  bool other_player = false;
+  for (int i = 0; i < search.NumNodes(); ++i) {
+    const dom::MctsSearch::Node& n = search.GetNode(i);
+    SPIEL_CHECK_EQ(n.in_flight.load(), 0);
+    other_player |= n.player >= 0 && n.player != victim;
+    int child_visits = 0;
+    for (int k = 0; k < search.NumChildren(i); ++k) {
+      child_visits += search.GetNode(search.Child(i, k)).visits.load();
+    }
+    SPIEL_CHECK_LE(child_visits, n.visits.load());
+    if (i == 0) SPIEL_CHECK_EQ(child_visits, config.simulations);
+  }
+  SPIEL_CHECK_TRUE(other_player);
+
+  // Full arenas: relocated edge blocks exhaust a small edge arena while nodes
+  // remain, and the search goes on with the tree it has.
+  config.max_nodes = 1000;
+  config.max_edges = 300;
+  config.simulations = 400;
+  config.max_rollout_moves = 0;
+  dom::MctsSearch small(config);
+  small.Search(static_cast<const dom::DominionState&>(*state));
+  SPIEL_CHECK_EQ(small.GetNode(0).visits.load(), config.simulations);
+  SPIEL_CHECK_LE(small.Stats().edges, config.max_edges);
+  for (int i = 0; i < small.NumNodes(); ++i) {
+    for (int k = 0; k < small.NumChildren(i); ++k) {
+      SPIEL_CHECK_GT(small.Child(i, k), 0);
+      SPIEL_CHECK_LT(small.Child(i, k), small.NumNodes());
+    }
+  }
+}
+
+// States that differ only in the seed of the last shuffle look the same to
+// every player whose hand the shuffle did not change.
+static void TestShuffleSeedHidden() {
+  std::shared_ptr<const Game> game = LoadGame("dominion");
+  std::mt19937 gen(5);
+  std::unique_ptr<State> state = game->NewInitialState();
+  while (!state->IsChanceNode()) {
+    if (state->IsTerminal()) state = game->NewInitialState();
+    std::vector<open_spiel::Action> la = state->LegalActions();
+    state->ApplyAction(la[std::uniform_int_distribution<size_t>(0, la.size() - 1)(gen)]);
+  }
+  std::vector<open_spiel::Action> seeds = state->LegalActions();
+  SPIEL_CHECK_GE(seeds.size(), 2u);
+  std::unique_ptr<State> a = state->Clone();
+  std::unique_ptr<State> b = state->Clone();
+  a->ApplyAction(seeds.front());
+  b->ApplyAction(seeds.back());
+  auto* da = static_cast<DominionState*>(a.get());
+  auto* db = static_cast<DominionState*>(b.get());
+  int compared = 0;
+  for (int p = 0; p < 2; ++p) {
+    if (da->player_states_[p].hand_counts_ != db->player_states_[p].hand_counts_) continue;
+    SPIEL_CHECK_EQ(da->ObservationString(p), db->ObservationString(p));
+    SPIEL_CHECK_EQ(da->InformationStateString(p), db->InformationStateString(p));
+    SPIEL_CHECK_TRUE(da->InformationStateKey(p) == db->InformationStateKey(p));
+    SPIEL_CHECK_TRUE(da->InformationStateString(p).find("LastAction: Shuffle\n") !=
+                     std::string::npos);
+    compared += 1;
+  }
+  SPIEL_CHECK_GT(compared, 0);
+}
+
+// Two states that differ only in how the opponent's unseen cards are split
+// between hand, deck and discard resample identically: the split leaks
+// nothing, and publicly discarded cards stay in the discard.
+static void TestResampleHiddenSplit() {
+  std::shared_ptr<const Game> game = LoadGame("dominion");
+  std::unique_ptr<State> sa = game->NewInitialState();
+  std::unique_ptr<State> sb = sa->Clone();
+  auto* a = static_cast<DominionState*>(sa.get());
+  auto* b = static_cast<DominionState*>(sb.get());
+  const CardName hand_a[] = {CardName::CARD_Copper, CardName::CARD_Copper, CardName::CARD_Copper,
+                             CardName::CARD_Estate, CardName::CARD_Estate};
+  const CardName hand_b[] = {CardName::CARD_Copper, CardName::CARD_Gold, CardName::CARD_Copper,
+                             CardName::CARD_Estate, CardName::CARD_Silver};
+  DominionTestHarness::ResetPlayer(a, 1);
+  DominionTestHarness::ResetPlayer(b, 1);
+  for (CardName cn : hand_a) DominionTestHarness::AddCardToHand(a, 1, cn);
+  for (CardName cn : hand_b) DominionTestHarness::AddCardToHand(b, 1, cn);
+  DominionTestHarness::AddCardToDeck(a, 1, CardName::CARD_Copper);
+  DominionTestHarness::AddCardToDeck(a, 1, CardName::CARD_Silver);
+  DominionTestHarness::AddCardToDeck(b, 1, CardName::CARD_Estate);
+  DominionTestHarness::AddCardToDeck(b, 1, CardName::CARD_Copper);
+  DominionTestHarness::AddCardToDiscard(a, 1, CardName::CARD_Gold);
+  DominionTestHarness::AddCardToDiscard(b, 1, CardName::CARD_Copper);
+  // One Province was discarded in view of player 0.
+  for (DominionState* s : {a, b}) {
+    DominionTestHarness::AddCardToDiscard(s, 1, CardName::CARD_Province);
+    DominionTestHarness::PublicCards(s, 1).known_discard.fill(0);
+    DominionTestHarness::PublicCards(s, 1).known_hand.fill(0);
+    DominionTestHarness::PublicCards(s, 1).known_discard[static_cast<int>(CardName::CARD_Province)] = 1;
+  }
+  SPIEL_CHECK_EQ(a->InformationStateString(0), b->InformationStateString(0));
+
+  const int gold = static_cast<int>(CardName::CARD_Gold);
+  bool gold_moved = false;
+  for (int seed = 0; seed < 40; ++seed) {
+    std::unique_ptr<State> ca = a->Clone();
+    std::unique_ptr<State> cb = b->Clone();
+    auto* ra = static_cast<DominionState*>(ca.get());
+    auto* rb = static_cast<DominionState*>(cb.get());
+    std::mt19937 ga(seed), gb(seed);
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    ra->ResampleHiddenCards(0, [&]() { return dist(ga); });
+    rb->ResampleHiddenCards(0, [&]() { return dist(gb); });
+    const auto& pa = ra->player_states_[1];
+    const auto& pb = rb->player_states_[1];
+    SPIEL_CHECK_TRUE(pa.hand_counts_ == pb.hand_counts_);
+    SPIEL_CHECK_TRUE(pa.discard_counts_ == pb.discard_counts_);
+    SPIEL_CHECK_TRUE(pa.deck_ == pb.deck_);
+    SPIEL_CHECK_EQ(DominionTestHarness::HandSize(ra, 1), 5);
+    SPIEL_CHECK_EQ(DominionTestHarness::DeckSize(ra, 1), 2);
+    SPIEL_CHECK_EQ(DominionTestHarness::DiscardSize(ra, 1), 2);
+    SPIEL_CHECK_EQ(pa.discard_counts_[static_cast<int>(CardName::CARD_Province)], 1);
+    gold_moved |= pa.discard_counts_[gold] == 0;
+  }
+  SPIEL_CHECK_TRUE(gold_moved);
+}
+
+// JSON written before deck_counts, deck_rng, pending_draws and public_cards
+// existed still loads; the tracker is rebuilt from the cards each player holds.
+static void TestLegacyJsonLoads() {
+  std::shared_ptr<const Game> game = LoadGame("dominion");
+  std::unique_ptr<State> state = game->NewInitialState();
+  auto* ds = dynamic_cast<DominionState*>(state.get());
+  SPIEL_CHECK_TRUE(ds != nullptr);
+
+  nlohmann::json j = nlohmann::json::parse(ds->ToJson());
+  j.erase("pending_draws");
+  for (auto& pj : j["player_states"]) {
+    pj.erase("deck_counts");
+    pj.erase("deck_rng");
+    pj.erase("public_cards");
+  }
+  // A Copper already played by the current player.
+  const int copper = static_cast<int>(CardName::CARD_Copper);
+  const int estate = static_cast<int>(CardName::CARD_Estate);
+  const int me = DominionTestHarness::CurrentPlayer(ds);
+  auto& hand = j["player_states"][me]["hand_counts"];
+  auto& deck = j["player_states"][me]["deck"];
+  if (hand[copper].get<int>() > 0) {
+    hand[copper] = hand[copper].get<int>() - 1;
+  } else {
+    auto it = std::find(deck.begin(), deck.end(), copper);
+    SPIEL_CHECK_TRUE(it != deck.end());
+    deck.erase(it);
+  }
+  j["play_area"] = nlohmann::json::array({copper});
+
+  std::unique_ptr<State> loaded = game->NewInitialState(j);
+  auto* dl = dynamic_cast<DominionState*>(loaded.get());
+  SPIEL_CHECK_TRUE(dl != nullptr);
+  for (int p = 0; p < kNumPlayers; ++p) {
+    const auto& pc = DominionTestHarness::PublicCards(dl, p);
+    SPIEL_CHECK_EQ(pc.owned[copper], 7);
+    SPIEL_CHECK_EQ(pc.owned[estate], 3);
+    SPIEL_CHECK_EQ(pc.in_play[copper], p == me ? 1 : 0);
+    SPIEL_CHECK_EQ(pc.known_hand[copper], 0);
+    SPIEL_CHECK_EQ(pc.known_discard[copper], 0);
+  }
+  SPIEL_CHECK_EQ(DominionTestHarness::HandSize(dl, me) +
+                     DominionTestHarness::DeckSize(dl, me),
+                 9);
+  // The loaded state plays on and re-serializes with the new keys.
+  nlohmann::json out = nlohmann::json::parse(dl->ToJson());
+  SPIEL_CHECK_TRUE(out.contains("pending_draws"));
+  SPIEL_CHECK_TRUE(out["player_states"][me].contains("public_cards"));
+  SPIEL_CHECK_FALSE(dl->LegalActions().empty());
+
+  // Player entries loaded on their own rebuild the tracker too.
+  open_spiel::dominion::PlayerState ps(j["player_states"][1 - me]);
+  SPIEL_CHECK_EQ(ps.public_cards_.owned[copper], 7);
+  SPIEL_CHECK_EQ(ps.public_cards_.owned[estate], 3);
+}
@@ -47,6 +47,14 @@ ThroneRoomEffectNode::ThroneRoomEffectNode(int depth) {
   for (int i = 0; i < depth; ++i) increment_throne_depth();
 }
 
+CardName CellarEffectNode::card() const { return CardName::CARD_Cellar; }
+CardName ChapelEffectNode::card() const { return CardName::CARD_Chapel; }
+CardName RemodelTrashEffectNode::card() const { return CardName::CARD_Remodel; }
+CardName RemodelGainEffectNode::card() const { return CardName::CARD_Remodel; }
+CardName MilitiaEffectNode::card() const { return CardName::CARD_Militia; }
+CardName ThroneRoomEffectNode::card() const { return CardName::CARD_ThroneRoom; }
+CardName WorkshopEffectNode::card() const { return CardName::CARD_Workshop; }
+
 // Begin a fresh selection for an action card from hand.
 // - Sets pending choice to PlayActionFromHand
 // - Installs ThroneRoomSelectActionHandler on the front node
@@ -82,6 +90,27 @@ void ThroneRoomEffectNode::FinishSelection(DominionState& state, int player) {
   if (!p.effect_queue.empty()) p.effect_queue.pop_front();
 }
 
+void ThroneRoomEffectNode::PlayDoubled(DominionState& state, int player) {
+  auto& p = state.player_states_[player];
+  SPIEL_CHECK_TRUE(p.FrontEffect() == this);
+  // Cards reset the queue when they open a selection; keep this node out of
+  // it while the card plays.
+  std::unique_ptr<EffectNode> self = std::move(p.effect_queue.front());
+  p.effect_queue.pop_front();
+  const Card& spec = GetCardSpec(static_cast<CardName>(doubling_pile_));
+  while (plays_left_ > 0) {
+    --plays_left_;
+    spec.Play(state, player);
+    if (!p.effect_queue.empty()) {
+      p.effect_queue.push_back(std::move(self));
+      return;
+    }
+  }
+  doubling_pile_ = -1;
+  p.effect_queue.push_front(std::move(self));
+  ContinueOrFinish(state, player);
+}
+
 } // namespace dominion
 } // namespace open_spiel
 
@@ -90,21 +119,11 @@ namespace dominion {
 
 EffectNodeStructContents EffectNodeToStruct(const EffectNode& node) {
   EffectNodeStructContents s;
-  if (dynamic_cast<const CellarEffectNode*>(&node)) {
-    s.kind = static_cast<int>(CardName::CARD_Cellar);
-  } else if (dynamic_cast<const ChapelEffectNode*>(&node)) {
-    s.kind = static_cast<int>(CardName::CARD_Chapel);
-  } else if (dynamic_cast<const RemodelTrashEffectNode*>(&node)) {
-    s.kind = static_cast<int>(CardName::CARD_Remodel);
-  } else if (dynamic_cast<const RemodelGainEffectNode*>(&node)) {
-    s.kind = static_cast<int>(CardName::CARD_Remodel);
-  } else if (dynamic_cast<const MilitiaEffectNode*>(&node)) {
-    s.kind = static_cast<int>(CardName::CARD_Militia);
-  } else if (auto tr = dynamic_cast<const ThroneRoomEffectNode*>(&node)) {
-    s.kind = static_cast<int>(CardName::CARD_ThroneRoom);
+  s.kind = static_cast<int>(node.card());
+  if (auto tr = dynamic_cast<const ThroneRoomEffectNode*>(&node)) {
     s.throne_select_depth = tr->throne_depth();
-  } else if (dynamic_cast<const WorkshopEffectNode*>(&node)) {
-    s.kind = static_cast<int>(CardName::CARD_Workshop);
+    s.throne_doubling_pile = tr->doubling_pile();
+    s.throne_plays_left = tr->plays_left();
   }
   if (auto hs = node.hand_selection()) {
     s.hand = *hs;
@@ -147,6 +166,7 @@ std::unique_ptr<EffectNode> EffectNodeFromStruct(const EffectNodeStructContents&
     }
     case CardName::CARD_ThroneRoom: {
       auto n = std::unique_ptr<ThroneRoomEffectNode>(new ThroneRoomEffectNode(s.throne_select_depth));
+      n->set_doubling(s.throne_doubling_pile, s.throne_plays_left);
       if (pending_choice == PendingChoice::PlayActionFromHand) {
         n->on_action = ThroneRoomCard::ThroneRoomSelectActionHandler;
       }
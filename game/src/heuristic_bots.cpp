@@ -0,0 +1,390 @@
+#include "heuristic_bots.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <vector>
+
+#include "actions.hpp"
+#include "cards.hpp"
+#include "effects.hpp"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace dominion {
+
+namespace {
+
+struct CardInfo {
+  int cost = 0;
+  int coins = 0; // basic treasure value
+  bool action = false;
+  bool treasure = false;
+  bool curse = false;
+  int plus_actions = 0;
+  int plus_cards = 0;
+};
+
+const std::array<CardInfo, kNumSupplyPiles> &CardTable() {
+  static const auto table = [] {
+    std::array<CardInfo, kNumSupplyPiles> t{};
+    for (int j = 0; j < kNumSupplyPiles; ++j) {
+      const Card &spec = GetCardSpec(static_cast<CardName>(j));
+      CardInfo &c = t[j];
+      c.cost = spec.cost_;
+      c.coins = spec.IsBasicTreasure() ? spec.value_ : 0;
+      c.action = spec.IsAction();
+      c.treasure = spec.IsTreasure();
+      c.curse = static_cast<CardName>(j) == CardName::CARD_Curse;
+      c.plus_actions = spec.grant_action_;
+      c.plus_cards = spec.grant_draw_;
+    }
+    return t;
+  }();
+  return table;
+}
+
+constexpr int Idx(CardName cn) { return static_cast<int>(cn); }
+
+// How much a card is worth keeping in hand; discard and trash choices take
+// the lowest first. Junk (Curse, pure Victory) is <= 0.
+int KeepValue(int j) {
+  const CardInfo &c = CardTable()[j];
+  if (c.curse) return -1;
+  if (c.treasure) return 2 * c.coins + 1;
+  if (c.action) return c.cost + 1;
+  return 0;
+}
+
+// Everything one decision looks at, gathered once.
+struct View {
+  const DominionState &state;
+  HeuristicStrategy strategy;
+  Player player;
+  const PlayerState &ps;
+  std::bitset<kNumPlayerActions> legal;
+  std::array<int, kNumSupplyPiles> owned{};
+  int total_cards = 0;
+  int money = 0; // coins of all basic treasures owned
+  int provinces_left = 0;
+
+  View(const DominionState &s, HeuristicStrategy strat, const std::vector<Action> &actions)
+      : state(s), strategy(strat), player(s.CurrentPlayer()), ps(s.player_states_[player]) {
+    for (Action a : actions) {
+      if (a >= 0 && a < kNumPlayerActions) legal.set(a);
+    }
+    owned = ps.DeckCounts();
+    for (int j = 0; j < kNumSupplyPiles; ++j) {
+      owned[j] += ps.hand_counts_[j] + ps.discard_counts_[j];
+    }
+    if (s.current_player_ == player) {
+      for (CardName cn : s.play_area_) owned[Idx(cn)] += 1;
+    }
+    for (int j = 0; j < kNumSupplyPiles; ++j) {
+      total_cards += owned[j];
+      money += owned[j] * CardTable()[j].coins;
+    }
+    provinces_left = s.supply_piles_[Idx(CardName::CARD_Province)];
+  }
+
+  bool Legal(Action a) const { return a >= 0 && a < kNumPlayerActions && legal.test(a); }
+
+  // Hand coins if every basic treasure were played now.
+  int Coins() const {
+    int coins = state.coins_;
+    for (int j = 0; j < kNumSupplyPiles; ++j) coins += ps.hand_counts_[j] * CardTable()[j].coins;
+    if (state.merchants_played_ > 0 && ps.HandCount(CardName::CARD_Silver) > 0) {
+      coins += state.merchants_played_;
+    }
+    return coins;
+  }
+
+  // Cards of pile j in hand that the trashing rules would get rid of.
+  int Trashable(int j, int already_trashed_coins) const {
+    const int n = ps.hand_counts_[j];
+    if (n == 0) return 0;
+    if (j == Idx(CardName::CARD_Curse)) return n;
+    if (j == Idx(CardName::CARD_Estate)) return provinces_left > 2 ? n : 0;
+    if (j == Idx(CardName::CARD_Copper)) {
+      int spare = money - already_trashed_coins - kChapelMoneyFloor;
+      return std::max(0, std::min(n, spare));
+    }
+    return 0;
+  }
+};
+
+// Kingdom card the strategy adds to money and how many it wants; kNumSupplyPiles
+// when none.
+int WantedExtra(const View &v, int coins, int *wanted) {
+  switch (v.strategy) {
+    case HeuristicStrategy::kBigMoney:
+      break;
+    case HeuristicStrategy::kBigMoneySmithy:
+      if (coins >= 4 && coins <= 5) {
+        *wanted = std::min(3, 1 + v.total_cards / 12);
+        return Idx(CardName::CARD_Smithy);
+      }
+      break;
+    case HeuristicStrategy::kBigMoneyMilitia:
+      if (coins >= 4 && coins <= 5) {
+        *wanted = 2;
+        return Idx(CardName::CARD_Militia);
+      }
+      break;
+    case HeuristicStrategy::kBigMoneyWitch:
+      if (coins == 5 || (coins >= 6 && coins <= 7 && v.owned[Idx(CardName::CARD_Witch)] == 0)) {
+        *wanted = 2;
+        return Idx(CardName::CARD_Witch);
+      }
+      break;
+    case HeuristicStrategy::kChapelEngine:
+      if (coins >= 2 && coins <= 4 && v.state.turn_number_ <= 4) {
+        *wanted = 1;
+        return Idx(CardName::CARD_Chapel);
+      }
+      if (coins == 5 && v.provinces_left > 4) {
+        *wanted = 8;
+        return Idx(CardName::CARD_Laboratory);
+      }
+      break;
+  }
+  return kNumSupplyPiles;
+}
+
+// Pile the strategy takes with `coins` when `can_take(j)`; -1 for nothing.
+template <typename CanTake>
+int ChooseCard(const View &v, int coins, CanTake can_take) {
+  int wanted = 0;
+  int extra = WantedExtra(v, coins, &wanted);
+  if (extra < kNumSupplyPiles && v.owned[extra] < wanted && can_take(extra)) return extra;
+  const int left = v.provinces_left;
+  std::array<CardName, 3> order{};
+  int n = 0;
+  if (coins >= 8) {
+    order = {CardName::CARD_Province, CardName::CARD_Gold, CardName::CARD_Silver};
+    n = 3;
+  } else if (coins >= 6) {
+    if (left <= 4) {
+      order = {CardName::CARD_Duchy, CardName::CARD_Gold, CardName::CARD_Silver};
+    } else {
+      order = {CardName::CARD_Gold, CardName::CARD_Silver, CardName::CARD_Silver};
+    }
+    n = 3;
+  } else if (coins == 5) {
+    if (left <= 5) {
+      order = {CardName::CARD_Duchy, CardName::CARD_Silver, CardName::CARD_Silver};
+    } else {
+      order = {CardName::CARD_Silver, CardName::CARD_Silver, CardName::CARD_Silver};
+    }
+    n = 2;
+  } else if (coins >= 3) {
+    if (left <= 2) {
+      order = {CardName::CARD_Estate, CardName::CARD_Silver, CardName::CARD_Silver};
+    } else {
+      order = {CardName::CARD_Silver, CardName::CARD_Silver, CardName::CARD_Silver};
+    }
+    n = 2;
+  } else if (coins == 2 && left <= 3) {
+    order = {CardName::CARD_Estate, CardName::CARD_Estate, CardName::CARD_Estate};
+    n = 1;
+  }
+  for (int i = 0; i < n; ++i) {
+    if (can_take(Idx(order[i]))) return Idx(order[i]);
+  }
+  return -1;
+}
+
+// Order in which action cards are played: cantrips and villages, then
+// Throne Room with something to double, then terminals by strength.
+// Negative: do not play.
+int PlayPriority(const View &v, int j) {
+  const CardInfo &c = CardTable()[j];
+  const CardName cn = static_cast<CardName>(j);
+  if (cn == CardName::CARD_Chapel) {
+    int junk = 0, coins = 0;
+    for (int k = 0; k < kNumSupplyPiles; ++k) {
+      int t = v.Trashable(k, coins);
+      junk += t;
+      coins += t * CardTable()[k].coins;
+    }
+    return junk >= 2 || (junk >= 1 && v.Coins() < 3) ? 45 : -1;
+  }
+  if (cn == CardName::CARD_ThroneRoom) {
+    for (int k = 0; k < kNumSupplyPiles; ++k) {
+      if (k != j && v.ps.hand_counts_[k] > 0 && CardTable()[k].action) return 70;
+    }
+    return -1;
+  }
+  if (c.plus_actions > 0) return 100 + 10 * c.plus_cards + c.cost;
+  if (cn == CardName::CARD_Witch) return 60;
+  if (c.plus_cards > 0) return 50 + c.plus_cards;
+  if (cn == CardName::CARD_Militia) return 40;
+  return 10 + c.cost;
+}
+
+Action ChoosePlay(const View &v, bool throne) {
+  int best = -1, best_priority = -1;
+  for (int j = 0; j < kNumSupplyPiles; ++j) {
+    if (!v.Legal(ActionIds::PlayHandIndex(j))) continue;
+    int priority = PlayPriority(v, j);
+    if (throne && static_cast<CardName>(j) == CardName::CARD_Chapel) priority = -1;
+    if (priority > best_priority) {
+      best = j;
+      best_priority = priority;
+    }
+  }
+  if (best >= 0) return ActionIds::PlayHandIndex(best);
+  Action stop = throne ? ActionIds::ThroneHandSelectFinish() : ActionIds::EndActions();
+  return v.Legal(stop) ? stop : kInvalidAction;
+}
+
+Action ChooseBuy(const View &v) {
+  // Special treasures (not counted in Coins()) are played before buying.
+  for (int j = 0; j < kNumSupplyPiles; ++j) {
+    if (v.Legal(ActionIds::PlayHandIndex(j))) return ActionIds::PlayHandIndex(j);
+  }
+  int j = ChooseCard(v, v.Coins(), [&](int k) { return v.Legal(ActionIds::BuyFromSupply(k)); });
+  if (j >= 0) return ActionIds::BuyFromSupply(j);
+  return v.Legal(ActionIds::EndBuy()) ? ActionIds::EndBuy() : kInvalidAction;
+}
+
+Action ChooseGain(const View &v) {
+  int max_cost = -1, best = -1;
+  for (int j = 0; j < kNumSupplyPiles; ++j) {
+    if (!v.Legal(ActionIds::GainSelect(j))) continue;
+    if (CardTable()[j].cost > max_cost) {
+      max_cost = CardTable()[j].cost;
+      best = j;
+    }
+  }
+  if (best < 0) return kInvalidAction;
+  int j = ChooseCard(v, max_cost, [&](int k) { return v.Legal(ActionIds::GainSelect(k)); });
+  return ActionIds::GainSelect(j >= 0 ? j : best);
+}
+
+// Hand selections must go in ascending pile order, so the bot settles the
+// whole set first and then takes its lowest pile; re-deciding after each
+// pick yields the rest of the same set.
+Action ChooseDiscardOrTrash(const View &v, bool trash) {
+  const HandSelectionStruct *hs =
+      v.ps.FrontEffect() ? v.ps.FrontEffect()->hand_selection() : nullptr;
+  auto select = [&](int j) {
+    return trash ? ActionIds::TrashHandSelect(j) : ActionIds::DiscardHandSelect(j);
+  };
+  Action finish = trash ? ActionIds::TrashHandSelectFinish() : ActionIds::DiscardHandSelectFinish();
+  const bool may_finish = v.Legal(finish);
+
+  if (trash && may_finish) {
+    // Optional trashing (Chapel): the trashing rules, lowest pile first.
+    int coins = 0;
+    for (int j = 0; j < kNumSupplyPiles; ++j) {
+      int t = v.Trashable(j, coins);
+      if (t > 0 && v.Legal(select(j))) return select(j);
+      coins += t * CardTable()[j].coins;
+    }
+    return finish;
+  }
+
+  // Piles ordered by keep value; the `count` cheapest cards go.
+  int hand_size = v.ps.TotalHandSize();
+  int count = 1;
+  if (!trash && hs != nullptr && hs->target_hand_size_value() > 0) {
+    count = std::max(1, hand_size - hs->target_hand_size_value());
+  }
+  if (may_finish) {
+    // Optional discarding (Cellar): junk only.
+    int junk_pile = -1;
+    for (int j = 0; j < kNumSupplyPiles && junk_pile < 0; ++j) {
+      if (KeepValue(j) <= 0 && v.Legal(select(j))) junk_pile = j;
+    }
+    return junk_pile >= 0 ? select(junk_pile) : finish;
+  }
+  std::array<int, kNumSupplyPiles> piles;
+  for (int j = 0; j < kNumSupplyPiles; ++j) piles[j] = j;
+  std::stable_sort(piles.begin(), piles.end(),
+                   [](int a, int b) { return KeepValue(a) < KeepValue(b); });
+  int lowest = kNumSupplyPiles;
+  for (int j : piles) {
+    if (count <= 0) break;
+    int n = std::min(count, v.ps.hand_counts_[j]);
+    if (n > 0 && v.Legal(select(j))) lowest = std::min(lowest, j);
+    count -= n;
+  }
+  if (lowest < kNumSupplyPiles) return select(lowest);
+  for (int j : piles) {
+    if (v.Legal(select(j))) return select(j);
+  }
+  return kInvalidAction;
+}
+
+class HeuristicBot : public Bot {
+public:
+  explicit HeuristicBot(HeuristicStrategy strategy) : strategy_(strategy) {}
+
+  Action Step(const State &state) override {
+    return HeuristicAction(static_cast<const DominionState &>(state), strategy_);
+  }
+
+private:
+  HeuristicStrategy strategy_;
+};
+
+constexpr std::array<std::pair<HeuristicStrategy, const char *>, 5> kStrategyNames = {{
+    {HeuristicStrategy::kBigMoney, "bigmoney"},
+    {HeuristicStrategy::kBigMoneySmithy, "bm_smithy"},
+    {HeuristicStrategy::kBigMoneyMilitia, "bm_militia"},
+    {HeuristicStrategy::kBigMoneyWitch, "bm_witch"},
+    {HeuristicStrategy::kChapelEngine, "chapel"},
+}};
+
+} // namespace
+
+const char *HeuristicStrategyName(HeuristicStrategy strategy) {
+  for (const auto &[s, name] : kStrategyNames) {
+    if (s == strategy) return name;
+  }
+  return "unknown";
+}
+
+bool ParseHeuristicStrategy(const std::string &name, HeuristicStrategy *strategy) {
+  for (const auto &[s, n] : kStrategyNames) {
+    if (name == n) {
+      *strategy = s;
+      return true;
+    }
+  }
+  return false;
+}
+
+Action HeuristicAction(const DominionState &state, HeuristicStrategy strategy) {
+  std::vector<Action> legal = state.LegalActions();
+  SPIEL_CHECK_FALSE(legal.empty());
+  if (legal.size() == 1) return legal[0];
+  View v(state, strategy, legal);
+  Action a = kInvalidAction;
+  switch (v.ps.pending_choice) {
+    case PendingChoice::DiscardUpToCardsFromHand:
+      a = ChooseDiscardOrTrash(v, /*trash=*/false);
+      break;
+    case PendingChoice::TrashUpToCardsFromHand:
+      a = ChooseDiscardOrTrash(v, /*trash=*/true);
+      break;
+    case PendingChoice::PlayActionFromHand:
+      a = ChoosePlay(v, /*throne=*/true);
+      break;
+    case PendingChoice::SelectUpToCardsFromBoard:
+      a = ChooseGain(v);
+      break;
+    case PendingChoice::None:
+      a = state.phase_ == Phase::buyPhase ? ChooseBuy(v) : ChoosePlay(v, /*throne=*/false);
+      break;
+  }
+  return v.Legal(a) ? a : legal[0];
+}
+
+std::unique_ptr<Bot> MakeHeuristicBot(HeuristicStrategy strategy) {
+  return std::make_unique<HeuristicBot>(strategy);
+}
+
+} // namespace dominion
+} // namespace open_spiel
@@ -0,0 +1,62 @@
+#include "histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace open_spiel {
+namespace dominion {
+
+uint64_t LogLinearHistogram::BucketLow(int index) {
+  if (index < kSubBuckets) return static_cast<uint64_t>(index);
+  int shift = index / kSubBuckets - 1;
+  return static_cast<uint64_t>(kSubBuckets + index % kSubBuckets) << shift;
+}
+
+uint64_t LogLinearHistogram::BucketHigh(int index) {
+  if (index < kSubBuckets) return static_cast<uint64_t>(index);
+  int shift = index / kSubBuckets - 1;
+  return BucketLow(index) + ((uint64_t{1} << shift) - 1);
+}
+
+void LogLinearHistogram::RecordCount(uint64_t value, uint64_t count) {
+  AddBucket(BucketIndex(value), count);
+}
+
+void LogLinearHistogram::AddBucket(int index, uint64_t count) {
+  counts_[index] += count;
+  count_ += count;
+}
+
+void LogLinearHistogram::Merge(const LogLinearHistogram &other) {
+  for (int i = 0; i < kNumBuckets; ++i) counts_[i] += other.counts_[i];
+  count_ += other.count_;
+}
+
+uint64_t LogLinearHistogram::Min() const {
+  for (int i = 0; i < kNumBuckets; ++i) {
+    if (counts_[i]) return BucketLow(i);
+  }
+  return 0;
+}
+
+uint64_t LogLinearHistogram::Max() const {
+  for (int i = kNumBuckets - 1; i >= 0; --i) {
+    if (counts_[i]) return BucketHigh(i);
+  }
+  return 0;
+}
+
+uint64_t LogLinearHistogram::ValueAtPercentile(double percentile) const {
+  if (count_ == 0) return 0;
+  double p = std::clamp(percentile, 0.0, 100.0);
+  uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(p / 100.0 * count_)));
+  uint64_t seen = 0;
+  for (int i = 0; i < kNumBuckets; ++i) {
+    seen += counts_[i];
+    if (seen >= rank) return BucketHigh(i);
+  }
+  return Max();
+}
+
+} // namespace dominion
+} // namespace open_spiel
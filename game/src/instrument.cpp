@@ -0,0 +1,176 @@
+#include "instrument.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include "actions.hpp"
+#include "open_spiel/json/include/nlohmann/json.hpp"
+
+namespace open_spiel {
+namespace dominion {
+namespace instrument {
+
+namespace {
+constexpr const char *kProbeNames[kNumProbes] = {
+    "ApplyAction/Play",
+    "ApplyAction/DiscardSelect",
+    "ApplyAction/TrashSelect",
+    "ApplyAction/ThroneFinish",
+    "ApplyAction/EndActions",
+    "ApplyAction/Buy",
+    "ApplyAction/EndBuy",
+    "ApplyAction/GainSelect",
+    "ApplyAction/Chance",
+    "LegalActions",
+    "PendingEffectLegalActions",
+    "DrawCardsFor",
+    "Shuffle",
+    "Clone",
+    "CopyFrom",
+    "EffectHandler",
+    "SerializeJson",
+    "DeserializeJson",
+    "SerializeBinary",
+    "DeserializeBinary",
+};
+
+#ifdef DOMINION_INSTRUMENT
+// Lock-free push-only list of every thread's block. Blocks are never freed so
+// the totals of finished threads stay visible.
+std::atomic<ThreadProbes *> g_threads{nullptr};
+
+ThreadProbes *RegisterThread() {
+  auto *tp = new ThreadProbes;
+  tp->next = g_threads.load(std::memory_order_relaxed);
+  while (!g_threads.compare_exchange_weak(tp->next, tp, std::memory_order_release,
+                                          std::memory_order_relaxed)) {
+  }
+  return tp;
+}
+#endif
+} // namespace
+
+const char *ProbeName(Probe probe) {
+  int i = static_cast<int>(probe);
+  return i >= 0 && i < kNumProbes ? kProbeNames[i] : "?";
+}
+
+Probe ApplyProbe(Action action_id) {
+  if (action_id >= ActionIds::Shuffle()) return Probe::kApplyChance;
+  if (action_id >= ActionIds::GainSelectBase()) return Probe::kApplyGainSelect;
+  if (action_id == ActionIds::EndBuy()) return Probe::kApplyEndBuy;
+  if (action_id >= ActionIds::BuyBase()) return Probe::kApplyBuy;
+  if (action_id == ActionIds::EndActions()) return Probe::kApplyEndActions;
+  if (action_id == ActionIds::ThroneHandSelectFinish()) return Probe::kApplyThroneFinish;
+  if (action_id >= ActionIds::TrashHandBase()) return Probe::kApplyTrashSelect;
+  if (action_id >= ActionIds::DiscardHandBase()) return Probe::kApplyDiscardSelect;
+  return Probe::kApplyPlay;
+}
+
+const char *TickUnit() {
+#if defined(__x86_64__) || defined(__i386__)
+  return "cycles";
+#else
+  return "ns";
+#endif
+}
+
+#ifdef DOMINION_INSTRUMENT
+ThreadProbes &LocalProbes() {
+  thread_local ThreadProbes *local = RegisterThread();
+  return *local;
+}
+#endif
+
+std::array<ProbeTotals, kNumProbes> Snapshot() {
+  std::array<ProbeTotals, kNumProbes> totals{};
+#ifdef DOMINION_INSTRUMENT
+  for (ThreadProbes *tp = g_threads.load(std::memory_order_acquire); tp; tp = tp->next) {
+    for (int i = 0; i < kNumProbes; ++i) {
+      totals[i].count += tp->count[i].load(std::memory_order_relaxed);
+      totals[i].ticks += tp->ticks[i].load(std::memory_order_relaxed);
+    }
+  }
+#endif
+  return totals;
+}
+
+LogLinearHistogram Histogram(Probe probe) {
+  LogLinearHistogram hist;
+#ifdef DOMINION_INSTRUMENT
+  int p = static_cast<int>(probe);
+  for (ThreadProbes *tp = g_threads.load(std::memory_order_acquire); tp; tp = tp->next) {
+    for (int b = 0; b < LogLinearHistogram::kNumBuckets; ++b) {
+      uint64_t n = tp->latency[p][b].load(std::memory_order_relaxed);
+      if (n) hist.AddBucket(b, n);
+    }
+  }
+#else
+  static_cast<void>(probe);
+#endif
+  return hist;
+}
+
+void Reset() {
+#ifdef DOMINION_INSTRUMENT
+  for (ThreadProbes *tp = g_threads.load(std::memory_order_acquire); tp; tp = tp->next) {
+    for (int i = 0; i < kNumProbes; ++i) {
+      tp->count[i].store(0, std::memory_order_relaxed);
+      tp->ticks[i].store(0, std::memory_order_relaxed);
+      for (auto &cell : tp->latency[i]) cell.store(0, std::memory_order_relaxed);
+    }
+  }
+#endif
+}
+
+std::string ReportJson() {
+  auto totals = Snapshot();
+  nlohmann::json probes = nlohmann::json::object();
+  for (int i = 0; i < kNumProbes; ++i) {
+    const ProbeTotals &t = totals[i];
+    LogLinearHistogram hist = Histogram(static_cast<Probe>(i));
+    probes[kProbeNames[i]] = {
+        {"count", t.count},
+        {"ticks", t.ticks},
+        {"ticks_per_call", t.count ? static_cast<double>(t.ticks) / t.count : 0.0},
+        {"p50", hist.ValueAtPercentile(50)},
+        {"p99", hist.ValueAtPercentile(99)},
+        {"p999", hist.ValueAtPercentile(99.9)},
+        {"max", hist.Max()}};
+  }
+  nlohmann::json doc = {{"enabled", Enabled()}, {"tick_unit", TickUnit()}, {"probes", probes}};
+  return doc.dump(2);
+}
+
+std::string ReportText() {
+  auto totals = Snapshot();
+  std::vector<int> order;
+  for (int i = 0; i < kNumProbes; ++i) {
+    if (totals[i].count > 0) order.push_back(i);
+  }
+  std::sort(order.begin(), order.end(),
+            [&](int a, int b) { return totals[a].ticks > totals[b].ticks; });
+  std::string out;
+  char line[200];
+  std::snprintf(line, sizeof(line), "%-28s %14s %18s %14s %10s %10s %10s\n", "probe", "calls",
+                TickUnit(), "per call", "p50", "p99", "p999");
+  out += line;
+  for (int i : order) {
+    const ProbeTotals &t = totals[i];
+    LogLinearHistogram hist = Histogram(static_cast<Probe>(i));
+    std::snprintf(line, sizeof(line), "%-28s %14llu %18llu %14.1f %10llu %10llu %10llu\n",
+                  kProbeNames[i], static_cast<unsigned long long>(t.count),
+                  static_cast<unsigned long long>(t.ticks),
+                  static_cast<double>(t.ticks) / t.count,
+                  static_cast<unsigned long long>(hist.ValueAtPercentile(50)),
+                  static_cast<unsigned long long>(hist.ValueAtPercentile(99)),
+                  static_cast<unsigned long long>(hist.ValueAtPercentile(99.9)));
+    out += line;
+  }
+  return out;
+}
+
+} // namespace instrument
+} // namespace dominion
+} // namespace open_spiel
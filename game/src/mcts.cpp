@@ -0,0 +1,392 @@
+#include "mcts.hpp"
+
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+#include "open_spiel/spiel_utils.h"
+#include "selfplay.hpp"
+
+namespace open_spiel {
+namespace dominion {
+
+namespace {
+
+uint64_t PackChildren(int64_t first, int64_t count) {
+  return static_cast<uint64_t>(first) | (static_cast<uint64_t>(count) << 32);
+}
+int64_t FirstEdge(uint64_t children) { return static_cast<int64_t>(children & 0xffffffffu); }
+int NumEdges(uint64_t children) { return static_cast<int>(children >> 32); }
+
+void AddValue(std::atomic<double> *sum, double x) {
+  double cur = sum->load(std::memory_order_relaxed);
+  while (!sum->compare_exchange_weak(cur, cur + x, std::memory_order_relaxed)) {
+  }
+}
+
+// Resets `node` to a fresh edge (nodes are recycled after Reset/compaction).
+void InitNode(MctsSearch::Node *node, int16_t action, int8_t player) {
+  node->children.store(0, std::memory_order_relaxed);
+  node->visits.store(0, std::memory_order_relaxed);
+  node->in_flight.store(0, std::memory_order_relaxed);
+  node->value.store(0.0, std::memory_order_relaxed);
+  node->action = action;
+  node->player = player;
+  node->expanding.store(false, std::memory_order_relaxed);
+}
+
+} // namespace
+
+struct MctsSearch::Worker {
+  uint64_t rng = 0;
+  std::unique_ptr<DominionState> scratch;
+  std::vector<int> path;
+  std::vector<Action> actions; // legal actions of the current step, reused
+  std::bitset<kNumPlayerActions> legal;
+  std::function<double()> uniform;
+  int max_depth = 0;
+};
+
+MctsSearch::MctsSearch(const MctsConfig &config)
+    : config_(config), edge_capacity_(config.max_edges > 0
+                                          ? config.max_edges
+                                          : 2 * static_cast<int64_t>(config.max_nodes)) {
+  SPIEL_CHECK_GT(config_.simulations, 0);
+  SPIEL_CHECK_GT(config_.max_nodes, kNumPlayerActions);
+  SPIEL_CHECK_LE(edge_capacity_, static_cast<int64_t>(UINT32_MAX));
+  SPIEL_CHECK_GE(config_.num_threads, 1);
+  nodes_ = std::make_unique<Node[]>(config_.max_nodes);
+  edges_ = std::make_unique<int32_t[]>(edge_capacity_);
+  uint64_t stream = config_.seed;
+  for (int t = 0; t < config_.num_threads; ++t) {
+    auto w = std::make_unique<Worker>();
+    // Thread 0 uses the seed itself, so one-thread searches keep their stream.
+    w->rng = t == 0 ? config_.seed : SplitMix64(stream);
+    w->path.reserve(64);
+    w->actions.reserve(kNumPlayerActions);
+    Worker *wp = w.get();
+    w->uniform = [wp] { return static_cast<double>(SplitMix64(wp->rng) >> 11) * 0x1.0p-53; };
+    workers_.push_back(std::move(w));
+  }
+}
+
+MctsSearch::~MctsSearch() = default;
+
+void MctsSearch::Reset() {
+  num_nodes_.store(0, std::memory_order_relaxed);
+  num_edges_.store(0, std::memory_order_relaxed);
+  root_history_.clear();
+}
+
+int MctsSearch::NumNodes() const {
+  return std::min(num_nodes_.load(std::memory_order_relaxed), config_.max_nodes);
+}
+
+int MctsSearch::NumChildren(int node) const {
+  return NumEdges(nodes_[node].children.load(std::memory_order_acquire));
+}
+
+int MctsSearch::Child(int node, int k) const {
+  return edges_[FirstEdge(nodes_[node].children.load(std::memory_order_acquire)) + k];
+}
+
+Action MctsSearch::Search(const DominionState &state) {
+  SPIEL_CHECK_FALSE(state.IsTerminal());
+  SPIEL_CHECK_FALSE(state.IsChanceNode());
+  stats_ = MctsStats();
+  const Player player = state.CurrentPlayer();
+  int root = config_.reuse_tree ? FindReusableRoot(state) : -1;
+  if (root < 0) {
+    num_nodes_.store(1, std::memory_order_relaxed);
+    num_edges_.store(0, std::memory_order_relaxed);
+    InitNode(&nodes_[0], -1, -1);
+  } else {
+    if (root != 0) CompactFrom(root);
+    stats_.reused_nodes = NumNodes();
+    nodes_[0].action = -1;
+    nodes_[0].player = -1;
+  }
+  root_history_ = state.FullHistory();
+  for (auto &w : workers_) {
+    if (!w->scratch) w->scratch.reset(static_cast<DominionState *>(state.Clone().release()));
+    w->max_depth = 0;
+  }
+
+  next_simulation_.store(0, std::memory_order_relaxed);
+  auto run = [&](int t) {
+    while (next_simulation_.fetch_add(1, std::memory_order_relaxed) < config_.simulations) {
+      Simulate(workers_[t].get(), state);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int t = 1; t < config_.num_threads; ++t) threads.emplace_back(run, t);
+  run(0);
+  for (std::thread &t : threads) t.join();
+
+  stats_.simulations = config_.simulations;
+  stats_.nodes = NumNodes();
+  stats_.edges = num_edges_.load(std::memory_order_relaxed);
+  stats_.threads = config_.num_threads;
+  for (const auto &w : workers_) stats_.max_depth = std::max(stats_.max_depth, w->max_depth);
+
+  std::bitset<kNumPlayerActions> legal;
+  std::vector<Action> actions = state.LegalActions();
+  for (Action a : actions) legal.set(a);
+  int best = -1;
+  for (int k = 0; k < NumChildren(0); ++k) {
+    const int c = Child(0, k);
+    const Node &n = nodes_[c];
+    if (n.player != player || !legal.test(n.action)) continue;
+    if (best < 0 || n.visits.load() > nodes_[best].visits.load()) best = c;
+  }
+  return best >= 0 ? static_cast<Action>(nodes_[best].action) : actions[0];
+}
+
+int MctsSearch::FindReusableRoot(const DominionState &state) const {
+  if (NumNodes() == 0) return -1;
+  const std::vector<State::PlayerAction> &history = state.FullHistory();
+  if (history.size() < root_history_.size() ||
+      !std::equal(root_history_.begin(), root_history_.end(), history.begin())) {
+    return -1;
+  }
+  int node = 0;
+  for (size_t i = root_history_.size(); i < history.size(); ++i) {
+    if (history[i].player < 0) continue; // chance outcomes are not in the tree
+    int next = -1;
+    for (int k = 0; k < NumChildren(node) && next < 0; ++k) {
+      const Node &c = nodes_[Child(node, k)];
+      if (c.action == history[i].action && c.player == history[i].player) next = Child(node, k);
+    }
+    if (next < 0) return -1;
+    node = next;
+  }
+  return node;
+}
+
+// Breadth-first copy of the subtree at `root` into the spare arenas: a
+// node's new index is its position in the queue, and each edge block lists
+// consecutive nodes again.
+void MctsSearch::CompactFrom(int root) {
+  if (!spare_nodes_) {
+    spare_nodes_ = std::make_unique<Node[]>(config_.max_nodes);
+    spare_edges_ = std::make_unique<int32_t[]>(edge_capacity_);
+  }
+  auto copy = [&](int from, int to) {
+    const Node &src = nodes_[from];
+    Node *dst = &spare_nodes_[to];
+    InitNode(dst, src.action, src.player);
+    dst->visits.store(src.visits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    dst->value.store(src.value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  };
+  queue_.clear();
+  queue_.push_back(root);
+  copy(root, 0);
+  int64_t edges = 0;
+  for (size_t k = 0; k < queue_.size(); ++k) {
+    const int count = NumChildren(queue_[k]);
+    if (count == 0) continue;
+    spare_nodes_[k].children.store(PackChildren(edges, count), std::memory_order_relaxed);
+    for (int j = 0; j < count; ++j) {
+      const int index = static_cast<int>(queue_.size());
+      queue_.push_back(Child(queue_[k], j));
+      copy(queue_.back(), index);
+      spare_edges_[edges++] = index;
+    }
+  }
+  nodes_.swap(spare_nodes_);
+  edges_.swap(spare_edges_);
+  num_nodes_.store(static_cast<int>(queue_.size()), std::memory_order_relaxed);
+  num_edges_.store(edges, std::memory_order_relaxed);
+}
+
+int MctsSearch::AllocateNodes(int n) {
+  int cur = num_nodes_.load(std::memory_order_relaxed);
+  do {
+    if (cur + n > config_.max_nodes) return -1;
+  } while (!num_nodes_.compare_exchange_weak(cur, cur + n, std::memory_order_relaxed));
+  return cur;
+}
+
+int64_t MctsSearch::AllocateEdges(int64_t n) {
+  int64_t cur = num_edges_.load(std::memory_order_relaxed);
+  do {
+    if (cur + n > edge_capacity_) return -1;
+  } while (!num_edges_.compare_exchange_weak(cur, cur + n, std::memory_order_relaxed));
+  return cur;
+}
+
+void MctsSearch::Expand(int node, const std::vector<Action> &legal, Player player) {
+  Node &n = nodes_[node];
+  auto missing_actions = [&](std::bitset<kNumPlayerActions> *present) {
+    const uint64_t children = n.children.load(std::memory_order_acquire);
+    for (int64_t e = FirstEdge(children); e < FirstEdge(children) + NumEdges(children); ++e) {
+      const Node &c = nodes_[edges_[e]];
+      if (c.player == player) present->set(c.action);
+    }
+    int missing = 0;
+    for (Action a : legal) missing += !present->test(a);
+    return missing;
+  };
+  std::bitset<kNumPlayerActions> present;
+  if (missing_actions(&present) == 0) return;
+  if (n.expanding.exchange(true, std::memory_order_acquire)) return;
+  present.reset();
+  const int missing = missing_actions(&present);
+  if (missing > 0) {
+    const uint64_t children = n.children.load(std::memory_order_relaxed);
+    const int64_t first = FirstEdge(children);
+    const int count = NumEdges(children);
+    // Edges first: grow the block in place when it ends the edge arena, else
+    // take a fresh block at the end; readers keep using the old block until
+    // the release store below.
+    int64_t end = first + count;
+    int64_t reserved_begin = end, reserved_end = end + missing, block = first;
+    if (count == 0 || end + missing > edge_capacity_ ||
+        !num_edges_.compare_exchange_strong(end, end + missing, std::memory_order_relaxed)) {
+      block = AllocateEdges(count + missing);
+      reserved_begin = block;
+      reserved_end = block + count + missing;
+    }
+    const int first_node = block >= 0 ? AllocateNodes(missing) : -1;
+    if (first_node >= 0) {
+      int next = first_node;
+      for (Action a : legal) {
+        if (!present.test(a)) {
+          InitNode(&nodes_[next++], static_cast<int16_t>(a), static_cast<int8_t>(player));
+        }
+      }
+      if (block != first) std::copy(&edges_[first], &edges_[first] + count, &edges_[block]);
+      for (int j = 0; j < missing; ++j) edges_[block + count + j] = first_node + j;
+      n.children.store(PackChildren(block, count + missing), std::memory_order_release);
+    } else if (block >= 0) {
+      // No room for the nodes: return the edges unless another block
+      // followed them.
+      num_edges_.compare_exchange_strong(reserved_end, reserved_begin,
+                                         std::memory_order_relaxed);
+    }
+  }
+  n.expanding.store(false, std::memory_order_release);
+}
+
+// UCB1 over the children that are legal for `player` in this simulation,
+// counting simulations in flight as losses; untried ones first. -1 if none
+// is legal.
+int MctsSearch::SelectChild(const Worker &w, int node, Player player) const {
+  const Node &n = nodes_[node];
+  const int parent_visits = n.visits.load(std::memory_order_relaxed) +
+                            n.in_flight.load(std::memory_order_relaxed);
+  const double log_visits = std::log(static_cast<double>(std::max(1, parent_visits)));
+  const uint64_t children = n.children.load(std::memory_order_acquire);
+  int best = -1;
+  double best_score = -std::numeric_limits<double>::infinity();
+  for (int64_t e = FirstEdge(children); e < FirstEdge(children) + NumEdges(children); ++e) {
+    const int c = edges_[e];
+    const Node &child = nodes_[c];
+    if (child.player != player || !w.legal.test(child.action)) continue;
+    const int in_flight = child.in_flight.load(std::memory_order_relaxed);
+    const int visits = child.visits.load(std::memory_order_relaxed) + in_flight;
+    if (visits == 0) return c;
+    const double value =
+        child.value.load(std::memory_order_relaxed) - config_.virtual_loss * in_flight;
+    const double score = value / visits + config_.uct_c * std::sqrt(log_visits / visits);
+    if (score > best_score) {
+      best = c;
+      best_score = score;
+    }
+  }
+  return best;
+}
+
+void MctsSearch::Evaluate(Worker *w, DominionState *state,
+                          std::array<double, kNumPlayers> *values) {
+  values->fill(0.0);
+  if (!state->IsTerminal() && config_.evaluator) {
+    config_.evaluator(*state, values);
+    return;
+  }
+  for (int n = 0; n < config_.max_rollout_moves && !state->IsTerminal(); ++n) {
+    if (state->IsChanceNode()) {
+      state->ApplyAction(SampleChanceOutcome(*state, w->rng));
+    } else if (config_.heuristic_rollout) {
+      state->ApplyAction(HeuristicAction(*state, config_.rollout_strategy));
+    } else {
+      state->LegalActions(&w->actions);
+      state->ApplyAction(
+          w->actions[ScaleToRange(SplitMix64(w->rng), static_cast<int>(w->actions.size()))]);
+    }
+  }
+  if (!state->IsTerminal()) return;
+  std::vector<double> returns = state->Returns();
+  for (int p = 0; p < kNumPlayers; ++p) (*values)[p] = returns[p];
+}
+
+void MctsSearch::Simulate(Worker *w, const DominionState &root) {
+  DominionState &s = *w->scratch;
+  s.CopyFrom(root);
+  if (config_.determinize) s.ResampleHiddenCards(root.CurrentPlayer(), w->uniform);
+  w->path.clear();
+  w->path.push_back(0);
+  nodes_[0].in_flight.fetch_add(1, std::memory_order_relaxed);
+  int node = 0;
+  while (!s.IsTerminal()) {
+    // A leaf is evaluated on its first visit and expanded on its second.
+    if (node != 0 && nodes_[node].visits.load(std::memory_order_relaxed) == 0) break;
+    const Player player = s.CurrentPlayer();
+    s.LegalActions(&w->actions);
+    Expand(node, w->actions, player);
+    w->legal.reset();
+    for (Action a : w->actions) w->legal.set(a);
+    const int child = SelectChild(*w, node, player);
+    if (child < 0) break;
+    nodes_[child].in_flight.fetch_add(1, std::memory_order_relaxed);
+    s.ApplyAction(nodes_[child].action);
+    while (s.IsChanceNode()) s.ApplyAction(SampleChanceOutcome(s, w->rng));
+    w->path.push_back(child);
+    node = child;
+  }
+  std::array<double, kNumPlayers> values;
+  Evaluate(w, &s, &values);
+  w->max_depth = std::max(w->max_depth, static_cast<int>(w->path.size()) - 1);
+  for (int i : w->path) {
+    Node &n = nodes_[i];
+    if (n.player >= 0) AddValue(&n.value, values[n.player]);
+    n.visits.fetch_add(1, std::memory_order_relaxed);
+    n.in_flight.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+void MctsSearch::RootVisitCounts(std::array<int, kNumPlayerActions> *counts) const {
+  counts->fill(0);
+  if (NumNodes() == 0) return;
+  for (int k = 0; k < NumChildren(0); ++k) {
+    const Node &c = nodes_[Child(0, k)];
+    (*counts)[c.action] += c.visits.load(std::memory_order_relaxed);
+  }
+}
+
+namespace {
+
+class MctsBot : public Bot {
+public:
+  explicit MctsBot(const MctsConfig &config) : search_(config) {}
+
+  Action Step(const State &state) override {
+    return search_.Search(static_cast<const DominionState &>(state));
+  }
+  void Restart() override { search_.Reset(); }
+  void RestartAt(const State &) override { search_.Reset(); }
+
+private:
+  MctsSearch search_;
+};
+
+} // namespace
+
+std::unique_ptr<Bot> MakeMctsBot(const MctsConfig &config) {
+  return std::make_unique<MctsBot>(config);
+}
+
+} // namespace dominion
+} // namespace open_spiel
@@ -0,0 +1,189 @@
+// Python bindings for batched Dominion play (module `pydominion`).
+//
+// BatchEnv outputs are exposed as read-only NumPy arrays that view the
+// environment's own buffers: no copy is made, and the same arrays show the
+// new contents after every step. Build with -DDOMINION_PYTHON=ON (see
+// BUILD.md).
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "batch_env.hpp"
+#include "dominion.hpp"
+#include "open_spiel/spiel.h"
+
+namespace py = pybind11;
+
+namespace {
+
+using open_spiel::Action;
+using open_spiel::GameParameter;
+using open_spiel::GameParameters;
+using open_spiel::dominion::BatchEnv;
+using open_spiel::dominion::DominionState;
+using open_spiel::dominion::kNumPlayers;
+using open_spiel::dominion::kObservationBytes;
+
+// A read-only array over `data` that keeps `owner` (the Python BatchEnv)
+// alive for as long as the array exists.
+template <typename T>
+py::array View(const T *data, std::vector<py::ssize_t> shape, py::handle owner) {
+  py::array_t<T> array(std::move(shape), data, owner);
+  array.attr("flags").attr("writeable") = false;
+  return std::move(array);
+}
+
+GameParameters ToGameParameters(const py::dict &params) {
+  GameParameters out;
+  for (const auto &item : params) {
+    std::string key = py::cast<std::string>(item.first);
+    py::handle value = item.second;
+    // bool first: Python bools are ints too.
+    if (py::isinstance<py::bool_>(value)) {
+      out[key] = GameParameter(py::cast<bool>(value));
+    } else if (py::isinstance<py::int_>(value)) {
+      out[key] = GameParameter(py::cast<int>(value));
+    } else if (py::isinstance<py::float_>(value)) {
+      out[key] = GameParameter(py::cast<double>(value));
+    } else if (py::isinstance<py::str>(value)) {
+      out[key] = GameParameter(py::cast<std::string>(value));
+    } else {
+      throw py::type_error("game parameter '" + key + "' must be bool, int, float or str");
+    }
+  }
+  return out;
+}
+
+std::unique_ptr<BatchEnv> MakeBatchEnv(int batch_size, uint64_t seed, const py::dict &params,
+                                       int max_moves) {
+  if (batch_size <= 0) throw py::value_error("batch_size must be positive");
+  if (max_moves <= 0) throw py::value_error("max_moves must be positive");
+  GameParameters game_params = ToGameParameters(params);
+  // Every game is a function of the seed unless the caller says otherwise.
+  if (game_params.find("opening_chance") == game_params.end()) {
+    game_params["opening_chance"] = GameParameter(true);
+  }
+  return std::make_unique<BatchEnv>(open_spiel::LoadGame("dominion", game_params), batch_size, seed,
+                                    max_moves);
+}
+
+// Checks every action against the current legal mask, so a bad action is a
+// Python exception rather than a fatal engine error inside the released-GIL
+// section.
+void CheckActions(const BatchEnv &env, const int64_t *actions) {
+  const uint8_t *mask = env.LegalMask();
+  for (int i = 0; i < env.BatchSize(); ++i) {
+    int64_t a = actions[i];
+    if (a < 0 || a >= BatchEnv::kLegalMaskStride ||
+        !mask[static_cast<size_t>(i) * BatchEnv::kLegalMaskStride + a]) {
+      throw py::value_error("illegal action " + std::to_string(a) + " in game " +
+                            std::to_string(i));
+    }
+  }
+}
+
+void CheckSlot(const BatchEnv &env, int i) {
+  if (i < 0 || i >= env.BatchSize()) throw py::index_error("game index out of range");
+}
+
+} // namespace
+
+PYBIND11_MODULE(pydominion, m) {
+  m.doc() = "Batched Dominion environment with zero-copy NumPy outputs";
+  m.attr("NUM_PLAYERS") = kNumPlayers;
+  m.attr("NUM_ACTIONS") = BatchEnv::kLegalMaskStride;
+  m.attr("OBSERVATION_BYTES") = kObservationBytes;
+
+  py::class_<BatchEnv>(m, "BatchEnv", R"doc(
+N Dominion games stepped in lockstep (see include/batch_env.hpp).
+
+The output properties are read-only NumPy views of buffers owned by the
+environment. They are updated in place by step() and reset(); copy them
+if a value must outlive the next step.
+)doc")
+      .def(py::init(&MakeBatchEnv), py::arg("batch_size"), py::arg("seed") = 0,
+           py::arg("params") = py::dict(), py::arg("max_moves") = 5000,
+           "params: Dominion game parameters; opening_chance defaults to True.")
+      .def_property_readonly("batch_size", &BatchEnv::BatchSize)
+      .def_property_readonly("episodes_completed", &BatchEnv::EpisodesCompleted)
+      .def(
+          "reset",
+          [](BatchEnv &env) {
+            py::gil_scoped_release release;
+            env.Reset();
+          })
+      .def(
+          "step",
+          [](BatchEnv &env, py::array_t<int64_t, py::array::c_style | py::array::forcecast> actions) {
+            if (actions.ndim() != 1 || actions.shape(0) != env.BatchSize()) {
+              throw py::value_error("actions must have shape (batch_size,)");
+            }
+            const int64_t *data = actions.data();
+            CheckActions(env, data);
+            static_assert(sizeof(Action) == sizeof(int64_t), "Action is not 64-bit");
+            py::gil_scoped_release release;
+            env.Step(reinterpret_cast<const Action *>(data));
+          },
+          py::arg("actions"), "Applies actions[i] to game i; the GIL is released while stepping.")
+      .def_property_readonly("observations",
+                             [](py::object self) {
+                               const auto &env = self.cast<const BatchEnv &>();
+                               return View(env.Observations(),
+                                           {env.BatchSize(), kObservationBytes}, self);
+                             })
+      .def_property_readonly("legal_mask",
+                             [](py::object self) {
+                               const auto &env = self.cast<const BatchEnv &>();
+                               return View(env.LegalMask(),
+                                           {env.BatchSize(), BatchEnv::kLegalMaskStride}, self);
+                             })
+      .def_property_readonly("current_players",
+                             [](py::object self) {
+                               const auto &env = self.cast<const BatchEnv &>();
+                               return View(env.CurrentPlayers(), {env.BatchSize()}, self);
+                             })
+      .def_property_readonly("rewards",
+                             [](py::object self) {
+                               const auto &env = self.cast<const BatchEnv &>();
+                               return View(env.Rewards(), {env.BatchSize(), kNumPlayers}, self);
+                             })
+      .def_property_readonly("terminals",
+                             [](py::object self) {
+                               const auto &env = self.cast<const BatchEnv &>();
+                               return View(env.Terminals(), {env.BatchSize()}, self);
+                             })
+      .def_property_readonly("truncations",
+                             [](py::object self) {
+                               const auto &env = self.cast<const BatchEnv &>();
+                               return View(env.Truncations(), {env.BatchSize()}, self);
+                             })
+      .def(
+          "observation_string",
+          [](const BatchEnv &env, int i) {
+            CheckSlot(env, i);
+            const DominionState &s = env.GameState(i);
+            return s.ObservationString(s.CurrentPlayer());
+          },
+          py::arg("game"))
+      .def(
+          "action_to_string",
+          [](const BatchEnv &env, int i, Action action) {
+            CheckSlot(env, i);
+            const DominionState &s = env.GameState(i);
+            return s.ActionToString(s.CurrentPlayer(), action);
+          },
+          py::arg("game"), py::arg("action"))
+      .def(
+          "serialize",
+          [](const BatchEnv &env, int i) {
+            CheckSlot(env, i);
+            return env.GameState(i).Serialize();
+          },
+          py::arg("game"), "JSON state of one game, loadable by pyspiel's dominion game.");
+}
@@ -0,0 +1,23 @@
+"""Smoke test for the pydominion module: import, step, read-only views."""
+
+import numpy as np
+import pydominion
+
+env = pydominion.BatchEnv(batch_size=4, seed=1)
+obs, mask = env.observations, env.legal_mask
+assert obs.shape == (4, pydominion.OBSERVATION_BYTES), obs.shape
+assert mask.shape[0] == 4 and mask.any(axis=1).all()
+for view in (obs, mask, env.current_players, env.rewards, env.terminals, env.truncations):
+    assert not view.flags.writeable
+    try:
+        view[0] = 0
+    except ValueError:
+        pass
+    else:
+        raise AssertionError("view is writeable")
+
+before = obs.copy()
+for _ in range(20):
+    env.step(env.legal_mask.argmax(axis=1).astype(np.int64))
+assert not np.array_equal(before, obs), "observations view was not refreshed"
+print("pydominion OK")
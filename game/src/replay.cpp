@@ -0,0 +1,39 @@
+#include "replay.hpp"
+
+#include <utility>
+
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace dominion {
+
+KeyframedReplay::KeyframedReplay(std::shared_ptr<const Game> game,
+                                 std::vector<Action> history,
+                                 std::vector<ForcedMove> forced, int interval)
+    : game_(std::move(game)), history_(std::move(history)), forced_(std::move(forced)),
+      interval_(interval) {
+  SPIEL_CHECK_GT(interval_, 0);
+  std::unique_ptr<State> state = game_->NewInitialState();
+  auto *ds = dynamic_cast<DominionState *>(state.get());
+  SPIEL_CHECK_TRUE(ds != nullptr);
+  keyframes_.reserve(history_.size() / interval_ + 1);
+  keyframes_.push_back(state->Clone());
+  for (size_t start = 0; start + interval_ <= history_.size(); start += interval_) {
+    ds->ReplayHistory(history_.data() + start, interval_, forced_);
+    keyframes_.push_back(state->Clone());
+  }
+}
+
+std::unique_ptr<State> KeyframedReplay::StateAt(int k) const {
+  SPIEL_CHECK_GE(k, 0);
+  SPIEL_CHECK_LE(k, NumMoves());
+  int frame = k / interval_;
+  std::unique_ptr<State> state = keyframes_[frame]->Clone();
+  int start = frame * interval_;
+  static_cast<DominionState *>(state.get())
+      ->ReplayHistory(history_.data() + start, k - start, forced_);
+  return state;
+}
+
+} // namespace dominion
+} // namespace open_spiel
@@ -0,0 +1,253 @@
+#include "replay_store.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace dominion {
+
+// Lives at the start of the mapping; counters are shared by every process
+// that maps the file and are only touched through __atomic builtins.
+struct ReplayStore::Header {
+  char magic[4];
+  uint32_t version;
+  uint32_t record_size;
+  uint32_t reserved;
+  uint64_t capacity;
+  uint64_t count; // reserved slots, may exceed capacity after failed appends
+};
+
+namespace {
+
+constexpr char kStoreMagic[4] = {'D', 'R', 'S', '1'};
+constexpr uint32_t kStoreVersion = 2;
+// Records start on a cache line after the header.
+constexpr size_t kRecordsOffset = 64;
+
+uint64_t TreeLeaves(uint64_t capacity) {
+  uint64_t leaves = 1;
+  while (leaves < capacity) leaves *= 2;
+  return leaves;
+}
+
+// The sum tree starts on the first cache line past the records.
+size_t TreeOffset(uint64_t capacity) {
+  size_t end = kRecordsOffset + capacity * sizeof(StoredPosition);
+  return (end + 63) / 64 * 64;
+}
+
+size_t MappedBytes(uint64_t capacity) {
+  return TreeOffset(capacity) + 2 * TreeLeaves(capacity) * sizeof(double);
+}
+
+// Concurrent adds from any process commute, so every node ends up with the
+// sum of all changes below it even while other writers are mid-update.
+void AtomicAdd(double *p, double delta) {
+  double cur;
+  __atomic_load(p, &cur, __ATOMIC_RELAXED);
+  double next;
+  do {
+    next = cur + delta;
+  } while (!__atomic_compare_exchange(p, &cur, &next, false, __ATOMIC_ACQ_REL,
+                                      __ATOMIC_RELAXED));
+}
+
+// Redraw budget for a batch; a sampler returns what it has by then, which
+// only comes up short while most of the sampled slots are still in flight.
+int MaxDraws(int batch) { return 64 * batch + 1024; }
+
+double LoadTree(const double *p) {
+  double v;
+  __atomic_load(p, &v, __ATOMIC_ACQUIRE);
+  return v;
+}
+
+[[noreturn]] void FailErrno(const std::string &what, const std::string &path) {
+  SpielFatalError("ReplayStore: " + what + " " + path + ": " + std::strerror(errno));
+}
+
+void *MapFile(int fd, size_t bytes, const std::string &path) {
+  void *base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (base == MAP_FAILED) FailErrno("mmap", path);
+  return base;
+}
+
+} // namespace
+
+ReplayStore::ReplayStore(int fd, void *base, size_t mapped_bytes)
+    : fd_(fd), base_(base), mapped_bytes_(mapped_bytes),
+      header_(static_cast<Header *>(base)),
+      tree_(reinterpret_cast<double *>(static_cast<char *>(base) +
+                                       TreeOffset(header_->capacity))),
+      tree_leaves_(TreeLeaves(header_->capacity)) {}
+
+ReplayStore::~ReplayStore() {
+  munmap(base_, mapped_bytes_);
+  close(fd_);
+}
+
+std::unique_ptr<ReplayStore> ReplayStore::Create(const std::string &path,
+                                                 uint64_t capacity) {
+  static_assert(sizeof(Header) <= kRecordsOffset, "header overlaps records");
+  SPIEL_CHECK_GT(capacity, 0);
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) FailErrno("open", path);
+  size_t bytes = MappedBytes(capacity);
+  if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) FailErrno("ftruncate", path);
+  void *base = MapFile(fd, bytes, path);
+  auto *h = static_cast<Header *>(base);
+  std::memcpy(h->magic, kStoreMagic, sizeof(kStoreMagic));
+  h->version = kStoreVersion;
+  h->record_size = sizeof(StoredPosition);
+  h->capacity = capacity;
+  h->count = 0;
+  return std::unique_ptr<ReplayStore>(new ReplayStore(fd, base, bytes));
+}
+
+std::unique_ptr<ReplayStore> ReplayStore::Open(const std::string &path) {
+  int fd = open(path.c_str(), O_RDWR);
+  if (fd < 0) FailErrno("open", path);
+  struct stat st;
+  if (fstat(fd, &st) != 0) FailErrno("fstat", path);
+  SPIEL_CHECK_GE(static_cast<size_t>(st.st_size), kRecordsOffset);
+  void *base = MapFile(fd, st.st_size, path);
+  auto *h = static_cast<Header *>(base);
+  SPIEL_CHECK_TRUE(std::memcmp(h->magic, kStoreMagic, sizeof(kStoreMagic)) == 0);
+  SPIEL_CHECK_EQ(h->version, kStoreVersion);
+  SPIEL_CHECK_EQ(h->record_size, static_cast<uint32_t>(sizeof(StoredPosition)));
+  SPIEL_CHECK_EQ(static_cast<size_t>(st.st_size), MappedBytes(h->capacity));
+  return std::unique_ptr<ReplayStore>(new ReplayStore(fd, base, st.st_size));
+}
+
+StoredPosition &ReplayStore::Slot(uint64_t i) const {
+  return reinterpret_cast<StoredPosition *>(static_cast<char *>(base_) +
+                                            kRecordsOffset)[i];
+}
+
+uint64_t ReplayStore::Capacity() const { return header_->capacity; }
+
+uint64_t ReplayStore::Size() const {
+  return std::min(__atomic_load_n(&header_->count, __ATOMIC_ACQUIRE),
+                  header_->capacity);
+}
+
+bool ReplayStore::Ready(uint64_t i) const {
+  return i < Size() && __atomic_load_n(&Slot(i).ready, __ATOMIC_ACQUIRE) != 0;
+}
+
+const StoredPosition &ReplayStore::At(uint64_t i) const {
+  SPIEL_CHECK_TRUE(Ready(i));
+  return Slot(i);
+}
+
+bool ReplayStore::Append(const DominionState &state, const ActionsAndProbs &policy,
+                         float outcome, float priority) {
+  SPIEL_CHECK_FALSE(state.IsChanceNode());
+  SPIEL_CHECK_FALSE(state.IsTerminal());
+  std::string bytes = state.SerializeBinary();
+  SPIEL_CHECK_LE(bytes.size(), static_cast<size_t>(kMaxStoredStateBytes));
+  uint64_t i = __atomic_fetch_add(&header_->count, 1, __ATOMIC_ACQ_REL);
+  if (i >= header_->capacity) return false;
+
+  StoredPosition &rec = Slot(i);
+  Player player = state.CurrentPlayer();
+  rec.player = static_cast<uint8_t>(player);
+  rec.reserved = 0;
+  rec.state_size = static_cast<uint16_t>(bytes.size());
+  rec.outcome = outcome;
+  rec.priority = priority;
+  state.ObservationBytes(player, rec.observation);
+  std::memset(rec.legal_mask, 0, sizeof(rec.legal_mask));
+  for (Action a : state.LegalActions()) {
+    SPIEL_CHECK_LT(a, kNumPlayerActions);
+    rec.legal_mask[a >> 3] |= static_cast<uint8_t>(1 << (a & 7));
+  }
+  std::memset(rec.policy, 0, sizeof(rec.policy));
+  for (const auto &[a, p] : policy) {
+    SPIEL_CHECK_LT(a, kNumPlayerActions);
+    double q = std::clamp(p, 0.0, 1.0) * 65535.0 + 0.5;
+    rec.policy[a] = static_cast<uint16_t>(q);
+  }
+  std::memcpy(rec.state, bytes.data(), bytes.size());
+  // Before publishing, so SetPriority never races the initial weight.
+  SetTreePriority(i, priority);
+  __atomic_store_n(&rec.ready, 1u, __ATOMIC_RELEASE);
+  return true;
+}
+
+void ReplayStore::SetPriority(uint64_t i, float priority) {
+  SPIEL_CHECK_TRUE(Ready(i));
+  __atomic_store(&Slot(i).priority, &priority, __ATOMIC_RELAXED);
+  SetTreePriority(i, priority);
+}
+
+void ReplayStore::SetTreePriority(uint64_t i, float priority) {
+  double weight = priority > 0 ? priority : 0.0; // also maps NaN to 0
+  uint64_t node = tree_leaves_ + i;
+  double old;
+  __atomic_exchange(&tree_[node], &weight, &old, __ATOMIC_ACQ_REL);
+  double delta = weight - old;
+  if (delta == 0) return;
+  for (node /= 2; node >= 1; node /= 2) AtomicAdd(&tree_[node], delta);
+}
+
+void ReplayStore::SampleUniform(int batch, std::mt19937_64 &rng,
+                                std::vector<const StoredPosition *> *out) const {
+  out->clear();
+  uint64_t n = Size();
+  if (n == 0) return;
+  out->reserve(batch);
+  std::uniform_int_distribution<uint64_t> pick(0, n - 1);
+  // In-flight slots are rare (at most one per writer); redraw on hitting one.
+  for (int tries = 0;
+       static_cast<int>(out->size()) < batch && tries < MaxDraws(batch); ++tries) {
+    uint64_t i = pick(rng);
+    if (Ready(i)) out->push_back(&Slot(i));
+  }
+}
+
+void ReplayStore::SamplePrioritized(int batch, std::mt19937_64 &rng,
+                                    std::vector<const StoredPosition *> *out) const {
+  out->clear();
+  double total = LoadTree(&tree_[1]);
+  if (!(total > 0)) return;
+  out->reserve(batch);
+  std::uniform_real_distribution<double> u(0.0, total);
+  // A descent can land on an unpublished or zeroed leaf while another writer
+  // is between updating the leaf and its parents; redraw when it does.
+  for (int tries = 0;
+       static_cast<int>(out->size()) < batch && tries < MaxDraws(batch); ++tries) {
+    double x = u(rng);
+    uint64_t node = 1;
+    while (node < tree_leaves_) {
+      double left = LoadTree(&tree_[2 * node]);
+      if (x < left) {
+        node = 2 * node;
+      } else {
+        x -= left;
+        node = 2 * node + 1;
+      }
+    }
+    uint64_t i = node - tree_leaves_;
+    if (LoadTree(&tree_[node]) > 0 && Ready(i)) out->push_back(&Slot(i));
+  }
+}
+
+std::unique_ptr<State> ReplayStore::StateAt(const DominionGame &game,
+                                            uint64_t i) const {
+  const StoredPosition &rec = At(i);
+  return std::unique_ptr<State>(new DominionState(
+      game.shared_from_this(), reinterpret_cast<const char *>(rec.state),
+      rec.state_size));
+}
+
+} // namespace dominion
+} // namespace open_spiel
@@ -0,0 +1,162 @@
+#include "selfplay.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "actions.hpp"
+#include "heuristic_bots.hpp"
+#include "mcts.hpp"
+#include "trace.hpp"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace dominion {
+
+namespace {
+
+struct WorkerQueue {
+  std::mutex mu;
+  std::deque<int> games;
+};
+
+} // namespace
+
+Action SampleChanceOutcome(const State &state, uint64_t &stream) {
+  ActionsAndProbs outcomes = state.ChanceOutcomes();
+  // Uniform double in [0, 1) from the top 53 bits of the draw.
+  double r = static_cast<double>(SplitMix64(stream) >> 11) * 0x1.0p-53;
+  for (const auto &[action, prob] : outcomes) {
+    r -= prob;
+    if (r < 0) return action;
+  }
+  return outcomes.back().first;
+}
+
+BotFactory MakeBotFactory(const std::string &name) {
+  if (name == "random") {
+    return [](Player player, uint64_t seed) {
+      return MakeUniformRandomBot(player, static_cast<int>(seed & 0x7fffffff));
+    };
+  }
+  if (name == "mcts") {
+    return [](Player, uint64_t seed) {
+      MctsConfig config;
+      config.simulations = 200;
+      config.seed = seed;
+      return MakeMctsBot(config);
+    };
+  }
+  HeuristicStrategy strategy;
+  if (ParseHeuristicStrategy(name, &strategy)) {
+    return [strategy](Player, uint64_t) { return MakeHeuristicBot(strategy); };
+  }
+  SpielFatalError("Unknown self-play policy: '" + name + "'");
+}
+
+SelfPlayStats RunSelfPlay(const DominionGame &game, const SelfPlayConfig &config,
+                          const std::vector<BotFactory> &seats, const GameSink &sink) {
+  SPIEL_CHECK_EQ(static_cast<int>(seats.size()), kNumPlayers);
+  SPIEL_CHECK_GE(config.num_games, 0);
+  int num_threads = config.num_threads > 0
+                        ? config.num_threads
+                        : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+  num_threads = std::max(1, std::min(num_threads, std::max(1, config.num_games)));
+
+  // Contiguous runs keep neighbouring games on one thread until stealing
+  // starts.
+  std::vector<WorkerQueue> queues(num_threads);
+  for (int w = 0; w < num_threads; ++w) {
+    int begin = static_cast<int>(static_cast<int64_t>(config.num_games) * w / num_threads);
+    int end = static_cast<int>(static_cast<int64_t>(config.num_games) * (w + 1) / num_threads);
+    for (int g = begin; g < end; ++g) queues[w].games.push_back(g);
+  }
+
+  std::mutex sink_mu;
+  SelfPlayStats stats;
+  stats.threads = num_threads;
+  auto start = std::chrono::steady_clock::now();
+
+  // Own work from the back, stolen work from the front of the next
+  // non-empty queue; false once every queue is drained.
+  auto next_game = [&](int w, int *index, bool *stolen) {
+    *stolen = false;
+    {
+      std::lock_guard<std::mutex> lock(queues[w].mu);
+      if (!queues[w].games.empty()) {
+        *index = queues[w].games.back();
+        queues[w].games.pop_back();
+        return true;
+      }
+    }
+    for (int k = 1; k < num_threads; ++k) {
+      WorkerQueue &victim = queues[(w + k) % num_threads];
+      std::lock_guard<std::mutex> lock(victim.mu);
+      if (!victim.games.empty()) {
+        *index = victim.games.front();
+        victim.games.pop_front();
+        *stolen = true;
+        return true;
+      }
+    }
+    return false;
+  };
+
+  auto worker = [&](int w) {
+    int index = 0;
+    bool stolen = false;
+    while (next_game(w, &index, &stolen)) {
+      trace::GameSpan game_span;
+      SelfPlayGame rec;
+      rec.index = index;
+      rec.worker = w;
+      uint64_t mix = config.seed + 0x9E3779B97F4A7C15ULL * static_cast<uint64_t>(index + 1);
+      rec.seed = SplitMix64(mix);
+      uint64_t stream = rec.seed;
+      std::vector<std::unique_ptr<Bot>> bots;
+      for (Player p = 0; p < kNumPlayers; ++p) bots.push_back(seats[p](p, SplitMix64(stream)));
+
+      std::unique_ptr<State> state = game.NewInitialState();
+      if (sink) rec.initial = state->Clone();
+      while (!state->IsTerminal() && rec.moves < config.max_moves) {
+        Action action;
+        if (state->IsChanceNode()) {
+          action = SampleChanceOutcome(*state, stream);
+        } else {
+          Player player = state->CurrentPlayer();
+          action = bots[player]->Step(*state);
+          for (Player p = 0; p < kNumPlayers; ++p) {
+            if (p != player) bots[p]->InformAction(*state, player, action);
+          }
+        }
+        if (config.record_actions) rec.actions.push_back(action);
+        state->ApplyAction(action);
+        rec.moves += 1;
+      }
+      rec.capped = !state->IsTerminal();
+      rec.returns = rec.capped ? std::vector<double>(kNumPlayers, 0.0) : state->Returns();
+
+      std::lock_guard<std::mutex> lock(sink_mu);
+      stats.games += 1;
+      stats.capped += rec.capped;
+      stats.moves += rec.moves;
+      stats.steals += stolen;
+      for (int p = 0; p < kNumPlayers; ++p) stats.total_returns[p] += rec.returns[p];
+      if (sink) sink(rec);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int w = 1; w < num_threads; ++w) threads.emplace_back(worker, w);
+  worker(0);
+  for (std::thread &t : threads) t.join();
+
+  stats.seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return stats;
+}
+
+} // namespace dominion
+} // namespace open_spiel
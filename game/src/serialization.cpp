@@ -0,0 +1,188 @@
+#include "serialization.hpp"
+
+#include "dominion.hpp"
+#include "effects.hpp"
+#include "instrument.hpp"
+#include "open_spiel/spiel.h"
+
+namespace open_spiel {
+namespace dominion {
+
+namespace {
+
+uint8_t ModeFlags(bool explicit_chance, bool counts_deck, bool opening_chance) {
+  return static_cast<uint8_t>((explicit_chance ? 1 : 0) | (counts_deck ? 2 : 0) |
+                              (opening_chance ? 4 : 0));
+}
+
+void WriteEffect(ByteWriter &w, const EffectNodeStructContents &s) {
+  w.U8(static_cast<uint8_t>(s.kind));
+  w.SignedVarint(s.hand.target_hand_size);
+  w.SignedVarint(s.hand.last_selected_original_index);
+  w.Varint(static_cast<uint64_t>(s.hand.selection_count));
+  w.U8(static_cast<uint8_t>((s.hand.allow_finish_selection ? 1 : 0) |
+                            (s.hand.only_treasure ? 2 : 0) |
+                            (s.gain_only_treasure ? 4 : 0)));
+  w.Varint(static_cast<uint64_t>(s.gain_max_cost));
+  w.Varint(static_cast<uint64_t>(s.throne_select_depth));
+  w.SignedVarint(s.throne_doubling_pile);
+  w.Varint(static_cast<uint64_t>(s.throne_plays_left));
+}
+
+EffectNodeStructContents ReadEffect(ByteReader &r) {
+  EffectNodeStructContents s;
+  s.kind = r.U8();
+  s.hand.target_hand_size = static_cast<int>(r.SignedVarint());
+  s.hand.last_selected_original_index = static_cast<int>(r.SignedVarint());
+  s.hand.selection_count = static_cast<int>(r.Varint());
+  uint8_t flags = r.U8();
+  s.hand.allow_finish_selection = flags & 1;
+  s.hand.only_treasure = flags & 2;
+  s.gain_only_treasure = flags & 4;
+  s.gain_max_cost = static_cast<int>(r.Varint());
+  s.throne_select_depth = static_cast<int>(r.Varint());
+  s.throne_doubling_pile = static_cast<int>(r.SignedVarint());
+  s.throne_plays_left = static_cast<int>(r.Varint());
+  return s;
+}
+
+void WritePlayer(ByteWriter &w, const PlayerState &ps) {
+  w.Cards(ps.deck_);
+  w.Counts(ps.deck_counts_);
+  // The sampler seed is only live in counts-deck mode.
+  w.U8(ps.deck_rng_ != 0);
+  if (ps.deck_rng_ != 0) w.Fixed64(ps.deck_rng_);
+  w.Counts(ps.hand_counts_);
+  w.Counts(ps.discard_counts_);
+  w.U8(static_cast<uint8_t>(ps.pending_choice));
+  int nodes = 0;
+  for (const auto &node : ps.effect_queue) nodes += node != nullptr;
+  w.Varint(static_cast<uint64_t>(nodes));
+  for (const auto &node : ps.effect_queue) {
+    if (node) WriteEffect(w, EffectNodeToStruct(*node));
+  }
+  w.Counts(ps.public_cards_.owned);
+  w.Counts(ps.public_cards_.in_play);
+  w.Counts(ps.public_cards_.known_hand);
+  w.Counts(ps.public_cards_.known_discard);
+}
+
+void ReadPlayer(ByteReader &r, PlayerState &ps) {
+  r.Cards(&ps.deck_);
+  r.Counts(&ps.deck_counts_);
+  ps.deck_rng_ = r.U8() ? r.Fixed64() : 0;
+  r.Counts(&ps.hand_counts_);
+  r.Counts(&ps.discard_counts_);
+  ps.history_.clear();
+  ps.pending_choice = static_cast<PendingChoice>(r.U8());
+  ps.effect_queue.clear();
+  size_t nodes = r.Varint();
+  for (size_t i = 0; i < nodes; ++i) {
+    auto node = EffectNodeFromStruct(ReadEffect(r), ps.pending_choice);
+    if (node) ps.effect_queue.push_back(std::move(node));
+  }
+  r.Counts(&ps.public_cards_.owned);
+  r.Counts(&ps.public_cards_.in_play);
+  r.Counts(&ps.public_cards_.known_hand);
+  r.Counts(&ps.public_cards_.known_discard);
+  if (!ps.obs_state) ps.ResetObsState();
+}
+
+} // namespace
+
+DominionState::DominionState(std::shared_ptr<const Game> game, const char *data,
+                             size_t size)
+    : State(game) {
+  const auto &dgame = static_cast<const DominionGame &>(*game);
+  explicit_chance_ = dgame.ExplicitChance();
+  counts_deck_ = dgame.CountsDeck();
+  opening_chance_ = dgame.OpeningChance();
+  LoadBinary(data, size);
+}
+
+std::string DominionState::SerializeBinary() const {
+  DOMINION_PROBE_SCOPE(instrument::Probe::kSerializeBinary);
+  std::string out;
+  out.reserve(256);
+  ByteWriter w(&out);
+  w.U8(static_cast<uint8_t>(kBinaryStateMagic[0]));
+  w.U8(static_cast<uint8_t>(kBinaryStateMagic[1]));
+  w.U8(kBinaryStateVersion);
+  w.U8(ModeFlags(explicit_chance_, counts_deck_, opening_chance_));
+
+  w.U8(static_cast<uint8_t>(current_player_));
+  w.Varint(static_cast<uint64_t>(coins_));
+  w.Varint(static_cast<uint64_t>(turn_number_));
+  w.Varint(static_cast<uint64_t>(actions_));
+  w.Varint(static_cast<uint64_t>(buys_));
+  w.Varint(static_cast<uint64_t>(merchants_played_));
+  w.U8(static_cast<uint8_t>(phase_));
+  w.SignedVarint(last_player_to_go_);
+  w.U8(static_cast<uint8_t>((shuffle_pending_ ? 1 : 0) |
+                            (shuffle_pending_end_of_turn_ ? 2 : 0)));
+  w.SignedVarint(original_player_for_shuffle_);
+  w.Varint(static_cast<uint64_t>(pending_draw_count_after_shuffle_));
+  for (int n : pending_draws_) w.Varint(static_cast<uint64_t>(n));
+  // Supply is stored as the cards taken from each initial pile.
+  std::array<int, kNumSupplyPiles> taken;
+  for (int j = 0; j < kNumSupplyPiles; ++j) {
+    taken[j] = initial_supply_piles_[j] - supply_piles_[j];
+  }
+  w.Counts(initial_supply_piles_);
+  w.Counts(taken);
+  w.Cards(play_area_);
+  w.Varint(static_cast<uint64_t>(move_number_));
+  for (const auto &ps : player_states_) WritePlayer(w, ps);
+  return out;
+}
+
+void DominionState::DeserializeBinary(const std::string &bytes) {
+  LoadBinary(bytes.data(), bytes.size());
+}
+
+void DominionState::LoadBinary(const char *data, size_t size) {
+  DOMINION_PROBE_SCOPE(instrument::Probe::kDeserializeBinary);
+  ByteReader r(data, size);
+  SPIEL_CHECK_EQ(r.U8(), static_cast<uint8_t>(kBinaryStateMagic[0]));
+  SPIEL_CHECK_EQ(r.U8(), static_cast<uint8_t>(kBinaryStateMagic[1]));
+  SPIEL_CHECK_EQ(r.U8(), kBinaryStateVersion);
+  // States only load into a game with the same chance/deck representation.
+  SPIEL_CHECK_EQ(r.U8(), ModeFlags(explicit_chance_, counts_deck_, opening_chance_));
+
+  current_player_ = r.U8();
+  coins_ = static_cast<int>(r.Varint());
+  turn_number_ = static_cast<int>(r.Varint());
+  actions_ = static_cast<int>(r.Varint());
+  buys_ = static_cast<int>(r.Varint());
+  merchants_played_ = static_cast<int>(r.Varint());
+  phase_ = static_cast<Phase>(r.U8());
+  last_player_to_go_ = static_cast<int>(r.SignedVarint());
+  uint8_t shuffle_flags = r.U8();
+  shuffle_pending_ = shuffle_flags & 1;
+  shuffle_pending_end_of_turn_ = shuffle_flags & 2;
+  original_player_for_shuffle_ = static_cast<int>(r.SignedVarint());
+  pending_draw_count_after_shuffle_ = static_cast<int>(r.Varint());
+  for (int &n : pending_draws_) n = static_cast<int>(r.Varint());
+  r.Counts(&initial_supply_piles_);
+  r.Counts(&supply_piles_);
+  for (int j = 0; j < kNumSupplyPiles; ++j) {
+    supply_piles_[j] = initial_supply_piles_[j] - supply_piles_[j];
+  }
+  r.Cards(&play_area_);
+  move_number_ = static_cast<int>(r.Varint());
+  for (auto &ps : player_states_) ReadPlayer(r, ps);
+  SPIEL_CHECK_TRUE(r.AtEnd());
+  history_.clear();
+  forced_moves_.clear();
+  probe_move_ = 0;
+  probes_ = 0;
+}
+
+std::unique_ptr<State>
+DominionGame::DeserializeStateBinary(const std::string &bytes) const {
+  return std::unique_ptr<State>(
+      new DominionState(shared_from_this(), bytes.data(), bytes.size()));
+}
+
+} // namespace dominion
+} // namespace open_spiel
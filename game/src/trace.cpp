@@ -0,0 +1,172 @@
+#include "trace.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+namespace open_spiel {
+namespace dominion {
+namespace trace {
+
+namespace {
+
+struct Event {
+  const char *name;
+  uint64_t start_ns;
+  uint64_t end_ns;
+  int64_t arg;
+};
+
+struct ThreadRing {
+  std::mutex mu;
+  std::vector<Event> events; // ring storage, sized on first record
+  size_t next = 0;           // total events recorded since the last clear
+  int tid = 0;
+  ThreadRing *link = nullptr;
+};
+
+std::atomic<bool> g_enabled{false};
+std::atomic<int> g_ring_capacity{1 << 16};
+std::atomic<int> g_sample_every{1};
+std::atomic<int> g_next_tid{1};
+// Push-only list of every thread's ring; rings are never freed so events of
+// finished threads can still be written.
+std::atomic<ThreadRing *> g_rings{nullptr};
+
+thread_local uint64_t t_games = 0;
+thread_local uint64_t t_turn_start = 0;
+
+ThreadRing *RegisterRing() {
+  auto *ring = new ThreadRing;
+  ring->tid = g_next_tid.fetch_add(1, std::memory_order_relaxed);
+  ring->link = g_rings.load(std::memory_order_relaxed);
+  while (!g_rings.compare_exchange_weak(ring->link, ring, std::memory_order_release,
+                                        std::memory_order_relaxed)) {
+  }
+  return ring;
+}
+
+ThreadRing &LocalRing() {
+  thread_local ThreadRing *ring = RegisterRing();
+  return *ring;
+}
+
+void AppendJsonString(std::string *out, const char *s) {
+  out->push_back('"');
+  for (; *s; ++s) {
+    if (*s == '"' || *s == '\\') out->push_back('\\');
+    out->push_back(*s);
+  }
+  out->push_back('"');
+}
+
+} // namespace
+
+namespace internal {
+
+thread_local bool t_sampled = false;
+
+void Record(const char *name, uint64_t start_ns, uint64_t end_ns, int64_t arg) {
+  ThreadRing &ring = LocalRing();
+  std::lock_guard<std::mutex> lock(ring.mu);
+  if (ring.events.empty()) {
+    ring.events.resize(std::max(1, g_ring_capacity.load(std::memory_order_relaxed)));
+  }
+  ring.events[ring.next % ring.events.size()] = Event{name, start_ns, end_ns, arg};
+  ring.next += 1;
+}
+
+bool BeginGame() {
+  if (!g_enabled.load(std::memory_order_relaxed)) return false;
+  int every = std::max(1, g_sample_every.load(std::memory_order_relaxed));
+  return t_games++ % every == 0;
+}
+
+} // namespace internal
+
+void Enable(const TraceOptions &options) {
+  g_ring_capacity.store(options.ring_capacity, std::memory_order_relaxed);
+  g_sample_every.store(options.sample_every, std::memory_order_relaxed);
+  g_enabled.store(true, std::memory_order_release);
+}
+
+void Disable() { g_enabled.store(false, std::memory_order_release); }
+
+bool Enabled() { return g_enabled.load(std::memory_order_acquire); }
+
+void SetThreadSampled(bool sampled) { internal::t_sampled = sampled && Enabled(); }
+
+void Clear() {
+  for (ThreadRing *r = g_rings.load(std::memory_order_acquire); r; r = r->link) {
+    std::lock_guard<std::mutex> lock(r->mu);
+    r->next = 0;
+  }
+}
+
+bool WriteChromeTrace(const std::string &path) {
+  std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  bool first = true;
+  char buf[128];
+  std::vector<Event> events;
+  for (ThreadRing *r = g_rings.load(std::memory_order_acquire); r; r = r->link) {
+    size_t begin = 0;
+    {
+      std::lock_guard<std::mutex> lock(r->mu);
+      if (r->events.empty()) continue;
+      size_t n = std::min(r->next, r->events.size());
+      begin = r->next - n;
+      events.clear();
+      for (size_t i = begin; i < r->next; ++i) events.push_back(r->events[i % r->events.size()]);
+    }
+    for (const Event &e : events) {
+      if (!first) out.push_back(',');
+      first = false;
+      out += "{\"name\":";
+      AppendJsonString(&out, e.name);
+      std::snprintf(buf, sizeof(buf), ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f",
+                    r->tid, e.start_ns / 1e3, (e.end_ns - e.start_ns) / 1e3);
+      out += buf;
+      if (e.arg >= 0) {
+        std::snprintf(buf, sizeof(buf), ",\"args\":{\"value\":%lld}",
+                      static_cast<long long>(e.arg));
+        out += buf;
+      }
+      out.push_back('}');
+    }
+  }
+  out += "]}\n";
+  std::FILE *f = std::fopen(path.c_str(), "wb");
+  if (!f) return false;
+  bool ok = std::fwrite(out.data(), 1, out.size(), f) == out.size();
+  return std::fclose(f) == 0 && ok;
+}
+
+GameSpan::GameSpan()
+    : outer_sampled_(internal::t_sampled), sampled_(internal::BeginGame()),
+      start_(sampled_ ? internal::NowNs() : 0) {
+  internal::t_sampled = sampled_;
+  t_turn_start = start_;
+}
+
+GameSpan::~GameSpan() {
+  if (sampled_) {
+    uint64_t now = internal::NowNs();
+    internal::Record("turn", t_turn_start, now, -1);
+    internal::Record("game", start_, now, -1);
+  }
+  internal::t_sampled = outer_sampled_;
+}
+
+void TurnBoundary(int turn_number) {
+  if (!internal::t_sampled) return;
+  uint64_t now = internal::NowNs();
+  // Outside a GameSpan the first boundary only starts the clock.
+  if (t_turn_start != 0) internal::Record("turn", t_turn_start, now, turn_number);
+  t_turn_start = now;
+}
+
+} // namespace trace
+} // namespace dominion
+} // namespace open_spiel
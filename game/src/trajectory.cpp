@@ -0,0 +1,207 @@
+#include "trajectory.hpp"
+
+#include "serialization.hpp"
+#include "open_spiel/spiel_utils.h"
+
+#ifdef DOMINION_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace open_spiel {
+namespace dominion {
+
+namespace {
+
+enum BlockCodec : uint8_t { kRawBlock = 0, kDeflateBlock = 1 };
+
+// Step header: action id shifted past the two presence bits.
+constexpr uint64_t kHasPolicyBit = 2;
+constexpr uint64_t kHasValueBit = 1;
+
+// Reads one LEB128 varint from a stream; false on clean end of file.
+bool ReadStreamVarint(std::istream &in, uint64_t *v) {
+  *v = 0;
+  for (int shift = 0;; shift += 7) {
+    int c = in.get();
+    if (c == std::char_traits<char>::eof()) {
+      SPIEL_CHECK_EQ(shift, 0);
+      return false;
+    }
+    SPIEL_CHECK_LT(shift, 64);
+    *v |= static_cast<uint64_t>(c & 0x7F) << shift;
+    if (!(c & 0x80)) return true;
+  }
+}
+
+} // namespace
+
+std::unique_ptr<State> Trajectory::StateAt(const DominionGame &game, int k) const {
+  SPIEL_CHECK_GE(k, 0);
+  SPIEL_CHECK_LE(k, static_cast<int>(steps.size()));
+  std::unique_ptr<State> state = game.DeserializeStateBinary(initial_state);
+  // Forced moves are not stored, so ApplyAction re-derives them.
+  for (int i = 0; i < k; ++i) state->ApplyAction(steps[i].action);
+  return state;
+}
+
+TrajectoryWriter::TrajectoryWriter(const std::string &path) {
+  bool empty;
+  {
+    std::ifstream existing(path, std::ios::binary | std::ios::ate);
+    empty = !existing || existing.tellg() == 0;
+  }
+  out_.open(path, std::ios::binary | std::ios::app);
+  if (!out_) SpielFatalError("TrajectoryWriter: cannot open " + path);
+  if (empty) {
+    out_.put(kTrajectoryMagic[0]);
+    out_.put(kTrajectoryMagic[1]);
+    out_.put(static_cast<char>(kTrajectoryVersion));
+  }
+}
+
+TrajectoryWriter::~TrajectoryWriter() { Flush(); }
+
+void TrajectoryWriter::BeginGame(const DominionState &initial) {
+  SPIEL_CHECK_FALSE(in_game_);
+  in_game_ = true;
+  initial_ = initial.SerializeBinary();
+  game_.clear();
+  num_steps_ = 0;
+}
+
+void TrajectoryWriter::AddStep(Action action, const ActionsAndProbs *policy,
+                               const float *value) {
+  SPIEL_CHECK_TRUE(in_game_);
+  SPIEL_CHECK_GE(action, 0);
+  ByteWriter w(&game_);
+  bool has_policy = policy != nullptr && !policy->empty();
+  w.Varint(static_cast<uint64_t>(action) << 2 | (has_policy ? kHasPolicyBit : 0) |
+           (value != nullptr ? kHasValueBit : 0));
+  if (has_policy) {
+    w.Varint(policy->size());
+    for (const auto &[a, p] : *policy) {
+      w.Varint(static_cast<uint64_t>(a));
+      w.Float(static_cast<float>(p));
+    }
+  }
+  if (value != nullptr) w.Float(*value);
+  num_steps_ += 1;
+}
+
+void TrajectoryWriter::EndGame(const std::vector<double> &returns) {
+  SPIEL_CHECK_TRUE(in_game_);
+  SPIEL_CHECK_EQ(static_cast<int>(returns.size()), kNumPlayers);
+  std::string record;
+  record.reserve(initial_.size() + game_.size() + 32);
+  ByteWriter w(&record);
+  w.Bytes(initial_);
+  w.Varint(static_cast<uint64_t>(num_steps_));
+  record.append(game_);
+  for (double r : returns) w.Float(static_cast<float>(r));
+  ByteWriter(&block_).Bytes(record);
+  in_game_ = false;
+  if (block_.size() >= kTrajectoryBlockBytes) Flush();
+}
+
+void TrajectoryWriter::Flush() {
+  if (block_.empty()) return;
+  uint8_t codec = kRawBlock;
+  std::string stored;
+#ifdef DOMINION_HAVE_ZLIB
+  uLongf stored_size = compressBound(block_.size());
+  stored.resize(stored_size);
+  if (compress2(reinterpret_cast<Bytef *>(&stored[0]), &stored_size,
+                reinterpret_cast<const Bytef *>(block_.data()), block_.size(),
+                Z_DEFAULT_COMPRESSION) == Z_OK &&
+      stored_size < block_.size()) {
+    stored.resize(stored_size);
+    codec = kDeflateBlock;
+  }
+#endif
+  const std::string &payload = codec == kRawBlock ? block_ : stored;
+  std::string header;
+  ByteWriter w(&header);
+  w.U8(codec);
+  w.Varint(block_.size());
+  w.Varint(payload.size());
+  out_.write(header.data(), header.size());
+  out_.write(payload.data(), payload.size());
+  out_.flush();
+  block_.clear();
+}
+
+TrajectoryReader::TrajectoryReader(const std::string &path)
+    : in_(path, std::ios::binary) {
+  if (!in_) SpielFatalError("TrajectoryReader: cannot open " + path);
+  char header[3];
+  in_.read(header, sizeof(header));
+  SPIEL_CHECK_TRUE(in_.gcount() == sizeof(header));
+  SPIEL_CHECK_EQ(header[0], kTrajectoryMagic[0]);
+  SPIEL_CHECK_EQ(header[1], kTrajectoryMagic[1]);
+  SPIEL_CHECK_EQ(static_cast<uint8_t>(header[2]), kTrajectoryVersion);
+}
+
+bool TrajectoryReader::ReadBlock() {
+  int codec = in_.get();
+  if (codec == std::char_traits<char>::eof()) return false;
+  uint64_t raw_size = 0, stored_size = 0;
+  SPIEL_CHECK_TRUE(ReadStreamVarint(in_, &raw_size));
+  SPIEL_CHECK_TRUE(ReadStreamVarint(in_, &stored_size));
+  std::string stored(stored_size, '\0');
+  in_.read(&stored[0], stored_size);
+  SPIEL_CHECK_TRUE(static_cast<uint64_t>(in_.gcount()) == stored_size);
+  if (codec == kRawBlock) {
+    SPIEL_CHECK_EQ(raw_size, stored_size);
+    block_ = std::move(stored);
+  } else {
+    SPIEL_CHECK_EQ(codec, static_cast<int>(kDeflateBlock));
+#ifdef DOMINION_HAVE_ZLIB
+    block_.assign(raw_size, '\0');
+    uLongf out_size = raw_size;
+    SPIEL_CHECK_EQ(uncompress(reinterpret_cast<Bytef *>(&block_[0]), &out_size,
+                              reinterpret_cast<const Bytef *>(stored.data()),
+                              stored.size()),
+                   Z_OK);
+    SPIEL_CHECK_EQ(static_cast<uint64_t>(out_size), raw_size);
+#else
+    SpielFatalError("TrajectoryReader: deflate block but built without zlib");
+#endif
+  }
+  block_pos_ = 0;
+  return true;
+}
+
+bool TrajectoryReader::Next(Trajectory *trajectory) {
+  while (block_pos_ == block_.size()) {
+    if (!ReadBlock()) return false;
+  }
+  ByteReader outer(block_.data() + block_pos_, block_.size() - block_pos_);
+  std::string record = outer.Bytes();
+  block_pos_ += outer.Position();
+
+  ByteReader r(record.data(), record.size());
+  trajectory->initial_state = r.Bytes();
+  size_t num_steps = r.Varint();
+  trajectory->steps.assign(num_steps, TrajectoryStep{});
+  for (auto &step : trajectory->steps) {
+    uint64_t head = r.Varint();
+    step.action = static_cast<Action>(head >> 2);
+    if (head & kHasPolicyBit) {
+      size_t n = r.Varint();
+      step.policy.reserve(n);
+      for (size_t i = 0; i < n; ++i) {
+        Action a = static_cast<Action>(r.Varint());
+        step.policy.push_back({a, r.Float()});
+      }
+    }
+    step.has_value = head & kHasValueBit;
+    if (step.has_value) step.value = r.Float();
+  }
+  trajectory->returns.assign(kNumPlayers, 0.0);
+  for (double &ret : trajectory->returns) ret = r.Float();
+  SPIEL_CHECK_TRUE(r.AtEnd());
+  return true;
+}
+
+} // namespace dominion
+} // namespace open_spiel